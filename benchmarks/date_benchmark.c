@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../date.h"
+
+/**
+* Measures moving a date by an offset and counting the days between two dates, against
+* doing the same with dateTick one day at a time, the way the event manager used to schedule
+* events by a difference and tick its date. Offsets go from a day to a thousand years.
+* The ticking loops are repeated fewer times the larger the offset, each offset ticks about
+* as many days in total.
+*
+* Usage: date_benchmark [repetitions]
+*/
+
+#define DEFAULT_REPETITIONS 100000
+#define DAYS_IN_YEAR 360
+
+static const int offsets[] = {1, 30, DAYS_IN_YEAR, 10 * DAYS_IN_YEAR, 100 * DAYS_IN_YEAR, 1000 * DAYS_IN_YEAR};
+
+#define NUMBER_OFFSETS (sizeof(offsets) / sizeof(*offsets))
+
+//keeps the compiler from dropping the loops
+static volatile int sink;
+
+//returns the average time of moving a date by offset days with dateTick in nanoseconds
+static double timeTick(Date date, int offset, int repetitions) {
+    clock_t start = clock();
+    for (int r = 0; r < repetitions; r++) {
+        for (int i = 0; i < offset; i++) {
+            dateTick(date);
+        }
+    }
+    clock_t end = clock();
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / repetitions;
+}
+
+//returns the average time of moving a date by offset days with dateAddDays in nanoseconds
+static double timeAddDays(Date date, int offset, int repetitions) {
+    clock_t start = clock();
+    //the date goes back and forth, so it stays in the legal years
+    for (int r = 0; r < repetitions; r++) {
+        sink = dateAddDays(date, r % 2 == 0 ? offset : -offset);
+    }
+    clock_t end = clock();
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / repetitions;
+}
+
+//returns the average time of counting the days from date to later by ticking a copy of date in nanoseconds
+static double timeCountTicks(Date date, Date later, int repetitions) {
+    clock_t start = clock();
+    for (int r = 0; r < repetitions; r++) {
+        Date current = dateCopy(date);
+        int days = 0;
+        while (dateCompare(current, later) < 0) {
+            dateTick(current);
+            days++;
+        }
+        dateDestroy(current);
+        sink = days;
+    }
+    clock_t end = clock();
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / repetitions;
+}
+
+//returns the average time of dateDiffDays in nanoseconds
+static double timeDiffDays(Date date, Date later, int repetitions) {
+    clock_t start = clock();
+    for (int r = 0; r < repetitions; r++) {
+        sink = dateDiffDays(later, date);
+    }
+    clock_t end = clock();
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / repetitions;
+}
+
+int main(int argc, char *argv[]) {
+    int repetitions = argc > 1 ? atoi(argv[1]) : DEFAULT_REPETITIONS;
+    if (repetitions < 1) {
+        fprintf(stderr, "usage: %s [repetitions, at least 1]\n", argv[0]);
+        return 1;
+    }
+    printf("ns per date moved or days counted\n%-15s%15s%15s%15s%15s\n", "offset (days)", "dateTick loop",
+           "dateAddDays", "tick and count", "dateDiffDays");
+    for (unsigned o = 0; o < NUMBER_OFFSETS; o++) {
+        int offset = offsets[o];
+        Date date = dateCreate(1, 1, 2000);
+        Date later = dateCreate(1, 1, 2000);
+        if (!date || !later || !dateAddDays(later, offset)) {
+            dateDestroy(date);
+            dateDestroy(later);
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        int tick_repetitions = repetitions / offset > 0 ? repetitions / offset : 1;
+        //the dates are measured on before they are moved
+        double count_ticks = timeCountTicks(date, later, tick_repetitions);
+        double diff_days = timeDiffDays(date, later, repetitions);
+        double add_days = timeAddDays(later, offset, repetitions);
+        double tick = timeTick(date, offset, tick_repetitions);
+        printf("%-15d%15.1f%15.1f%15.1f%15.1f\n", offset, tick, add_days, count_ticks, diff_days);
+        dateDestroy(date);
+        dateDestroy(later);
+    }
+    return 0;
+}
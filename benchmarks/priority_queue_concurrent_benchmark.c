@@ -0,0 +1,165 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "../priority_queue.h"
+#include "../priority_queue_concurrent.h"
+
+/**
+* Measures the throughput of the concurrent priority queue as threads are added, next to
+* a binary heap PriorityQueue guarded by one mutex. Every thread alternates inserting an
+* element with a random priority and popping the first element, on a queue that starts
+* with some elements in it.
+*
+* Usage: priority_queue_concurrent_benchmark [max threads] [operations per thread]
+*/
+
+#define DEFAULT_MAX_THREADS 8
+#define DEFAULT_OPERATIONS 200000
+#define PREFILL 100000
+#define PRIORITY_RANGE 1000000
+
+static PQElement copyInt(PQElement n) {
+    int *copy = malloc(sizeof(*copy));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *(int *) n;
+    return copy;
+}
+
+static void freeInt(PQElement n) {
+    free(n);
+}
+
+static bool equalInts(PQElement n1, PQElement n2) {
+    return *(int *) n1 == *(int *) n2;
+}
+
+static int compareEarlierFirst(PQElementPriority n1, PQElementPriority n2) {
+    return *(int *) n2 - *(int *) n1;
+}
+
+//xorshift, so the threads do not share the state of rand
+static int nextRandom(unsigned *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return (int) (*state % PRIORITY_RANGE);
+}
+
+typedef struct {
+    ConcurrentPriorityQueue cpq;
+    PriorityQueue locked_pq;
+    pthread_mutex_t *lock;
+    int operations;
+    unsigned seed;
+} Worker;
+
+static void *concurrentWorker(void *argument) {
+    Worker *worker = argument;
+    for (int i = 0; i < worker->operations; i++) {
+        int key = nextRandom(&worker->seed);
+        cpqInsert(worker->cpq, &key, &key);
+        cpqPopFirst(worker->cpq, NULL, NULL);
+    }
+    return NULL;
+}
+
+static void *lockedWorker(void *argument) {
+    Worker *worker = argument;
+    for (int i = 0; i < worker->operations; i++) {
+        int key = nextRandom(&worker->seed);
+        pthread_mutex_lock(worker->lock);
+        pqInsert(worker->locked_pq, &key, &key);
+        pthread_mutex_unlock(worker->lock);
+        pthread_mutex_lock(worker->lock);
+        pqRemove(worker->locked_pq);
+        pthread_mutex_unlock(worker->lock);
+    }
+    return NULL;
+}
+
+static double secondsSince(const struct timespec *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double) (end.tv_sec - start->tv_sec) + (double) (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+//returns the millions of operations (an insert or a pop) per second, negative on failure
+static double timeWorkers(void *(*work)(void *), Worker *workers, int threads) {
+    pthread_t ids[threads];
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    while (started < threads && pthread_create(&ids[started], NULL, work, &workers[started]) == 0) {
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    double seconds = secondsSince(&start);
+    if (started < threads) {
+        return -1;
+    }
+    return 2.0 * workers[0].operations * threads / seconds / 1e6;
+}
+
+static double timeConcurrent(int threads, int operations) {
+    ConcurrentPriorityQueue cpq = cpqCreate(copyInt, freeInt, copyInt, freeInt, compareEarlierFirst);
+    if (!cpq) {
+        return -1;
+    }
+    unsigned seed = 1;
+    for (int i = 0; i < PREFILL; i++) {
+        int key = nextRandom(&seed);
+        cpqInsert(cpq, &key, &key);
+    }
+    Worker workers[threads];
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (Worker) {cpq, NULL, NULL, operations, (unsigned) i + 2};
+    }
+    double throughput = timeWorkers(concurrentWorker, workers, threads);
+    cpqDestroy(cpq);
+    return throughput;
+}
+
+static double timeLocked(int threads, int operations) {
+    PriorityQueue pq = pqCreateWithBackend(PQ_BACKEND_BINARY_HEAP, copyInt, freeInt, equalInts, copyInt, freeInt,
+                                           compareEarlierFirst);
+    if (!pq) {
+        return -1;
+    }
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+    unsigned seed = 1;
+    for (int i = 0; i < PREFILL; i++) {
+        int key = nextRandom(&seed);
+        pqInsert(pq, &key, &key);
+    }
+    Worker workers[threads];
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (Worker) {NULL, pq, &lock, operations, (unsigned) i + 2};
+    }
+    double throughput = timeWorkers(lockedWorker, workers, threads);
+    pthread_mutex_destroy(&lock);
+    pqDestroy(pq);
+    return throughput;
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+    int operations = argc > 2 ? atoi(argv[2]) : DEFAULT_OPERATIONS;
+    if (max_threads <= 0 || operations <= 0) {
+        fprintf(stderr, "usage: %s [max threads] [operations per thread]\n", argv[0]);
+        return 1;
+    }
+    printf("%d insert and pop pairs per thread on %d elements, millions of operations per second\n",
+           operations, PREFILL);
+    printf("%-10s%20s%20s\n", "threads", "concurrent heap", "locked binary heap");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        printf("%-10d%20.2f%20.2f\n", threads, timeConcurrent(threads, operations), timeLocked(threads, operations));
+    }
+    return 0;
+}
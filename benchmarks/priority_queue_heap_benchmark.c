@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../priority_queue.h"
+
+/**
+* Measures the array backed heaps on pop heavy work, at sizes from what fits in the
+* cache to well beyond it. Elements and priorities are ints kept inline, so the time
+* goes to sifting rather than to copying.
+*   drain - the queue is filled with random priorities and popped until it is empty.
+*   hold  - the queue stays at its size: every pop is followed by an insert of a
+*           priority a little after the popped one, the way a scheduler runs.
+*
+* Usage: priority_queue_heap_benchmark [largest size]
+*/
+
+#define DEFAULT_MAX_SIZE 1000000
+#define MIN_SIZE 1000
+#define SIZE_STEP 10
+#define HOLD_OPERATIONS 1000000
+#define HOLD_MAX_DELAY 1000
+#define PRIORITY_RANGE 1000000
+
+static bool equalInts(PQElement n1, PQElement n2) {
+    return *(int *) n1 == *(int *) n2;
+}
+
+static int compareEarlierFirst(PQElementPriority n1, PQElementPriority n2) {
+    return *(int *) n2 - *(int *) n1;
+}
+
+typedef struct {
+    const char *name;
+    PQBackend backend;
+} Backend;
+
+static const Backend backends[] = {
+        {"binary heap", PQ_BACKEND_BINARY_HEAP},
+        {"4-ary heap",  PQ_BACKEND_4_ARY_HEAP},
+        {"8-ary heap",  PQ_BACKEND_8_ARY_HEAP}
+};
+
+#define NUMBER_BACKENDS (sizeof(backends) / sizeof(*backends))
+
+//returns a queue filled with size random priorities, NULL on failure
+static PriorityQueue createFilled(PQBackend backend, int size) {
+    PriorityQueue pq = pqCreateInline(sizeof(int), sizeof(int), backend, equalInts, NULL, compareEarlierFirst);
+    if (!pq || pqReserve(pq, size) != PQ_SUCCESS) {
+        pqDestroy(pq);
+        return NULL;
+    }
+    srand(0);
+    for (int i = 0; i < size; i++) {
+        int key = rand() % PRIORITY_RANGE;
+        if (pqInsert(pq, &key, &key) != PQ_SUCCESS) {
+            pqDestroy(pq);
+            return NULL;
+        }
+    }
+    return pq;
+}
+
+//returns the average time of one pop in nanoseconds, negative on failure
+static double timeDrain(PQBackend backend, int size) {
+    PriorityQueue pq = createFilled(backend, size);
+    if (!pq) {
+        return -1;
+    }
+    clock_t start = clock();
+    for (int i = 0; i < size; i++) {
+        pqRemove(pq);
+    }
+    clock_t end = clock();
+    pqDestroy(pq);
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / size;
+}
+
+//returns the average time of one pop and insert pair in nanoseconds, negative on failure
+static double timeHold(PQBackend backend, int size) {
+    PriorityQueue pq = createFilled(backend, size);
+    if (!pq) {
+        return -1;
+    }
+    clock_t start = clock();
+    for (int i = 0; i < HOLD_OPERATIONS; i++) {
+        int key = *(int *) pqGetFirst(pq) + rand() % HOLD_MAX_DELAY;
+        pqRemove(pq);
+        if (pqInsert(pq, &key, &key) != PQ_SUCCESS) {
+            pqDestroy(pq);
+            return -1;
+        }
+    }
+    clock_t end = clock();
+    pqDestroy(pq);
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / HOLD_OPERATIONS;
+}
+
+static void printTable(const char *title, double (*measure)(PQBackend, int), int max_size) {
+    printf("%s\n%-10s", title, "size");
+    for (unsigned b = 0; b < NUMBER_BACKENDS; b++) {
+        printf("%15s", backends[b].name);
+    }
+    printf("\n");
+    for (int size = MIN_SIZE; size <= max_size; size *= SIZE_STEP) {
+        printf("%-10d", size);
+        for (unsigned b = 0; b < NUMBER_BACKENDS; b++) {
+            printf("%15.1f", measure(backends[b].backend, size));
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int max_size = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_SIZE;
+    if (max_size < MIN_SIZE) {
+        fprintf(stderr, "usage: %s [largest size, at least %d]\n", argv[0], MIN_SIZE);
+        return 1;
+    }
+    printTable("drain, ns per pop", timeDrain, max_size);
+    printf("\n");
+    printTable("hold, ns per pop and insert", timeHold, max_size);
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../priority_queue.h"
+
+/**
+* Measures pqInsert on the insertion orders an event scheduler produces.
+* Priorities are ints where a smaller number comes first, like dates: an
+* ascending trace always inserts the lowest priority so far.
+*
+* Usage: priority_queue_insert_benchmark [number of elements]
+*/
+
+#define DEFAULT_TRACE_LENGTH 20000
+#define NEARLY_SORTED_JITTER 8
+
+static PQElement copyInt(PQElement n) {
+    int *copy = malloc(sizeof(*copy));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *(int *) n;
+    return copy;
+}
+
+static void freeInt(PQElement n) {
+    free(n);
+}
+
+static bool equalInts(PQElement n1, PQElement n2) {
+    return *(int *) n1 == *(int *) n2;
+}
+
+static int compareEarlierFirst(PQElementPriority n1, PQElementPriority n2) {
+    return *(int *) n2 - *(int *) n1;
+}
+
+static void ascendingTrace(int *keys, int length) {
+    for (int i = 0; i < length; i++) {
+        keys[i] = i;
+    }
+}
+
+static void nearlySortedTrace(int *keys, int length) {
+    for (int i = 0; i < length; i++) {
+        keys[i] = i + rand() % NEARLY_SORTED_JITTER;
+    }
+}
+
+static void randomTrace(int *keys, int length) {
+    for (int i = 0; i < length; i++) {
+        keys[i] = rand() % length;
+    }
+}
+
+typedef struct {
+    const char *name;
+    void (*fill)(int *keys, int length);
+} Trace;
+
+typedef struct {
+    const char *name;
+    PQBackend backend;
+} Backend;
+
+static const Trace traces[] = {
+        {"ascending",     ascendingTrace},
+        {"nearly sorted", nearlySortedTrace},
+        {"random",        randomTrace}
+};
+
+static const Backend backends[] = {
+        {"list",        PQ_BACKEND_LIST},
+        {"binary heap", PQ_BACKEND_BINARY_HEAP},
+        {"pairing heap", PQ_BACKEND_PAIRING_HEAP},
+        {"min-max heap", PQ_BACKEND_MIN_MAX_HEAP},
+        {"skiplist",    PQ_BACKEND_SKIPLIST}
+};
+
+#define NUMBER_TRACES (sizeof(traces) / sizeof(*traces))
+#define NUMBER_BACKENDS (sizeof(backends) / sizeof(*backends))
+
+//returns the average time of one pqInsert in nanoseconds, negative on failure
+static double timeInserts(PQBackend backend, const int *keys, int length) {
+    PriorityQueue pq = pqCreateWithBackend(backend, copyInt, freeInt, equalInts, copyInt, freeInt,
+                                           compareEarlierFirst);
+    if (!pq) {
+        return -1;
+    }
+    clock_t start = clock();
+    for (int i = 0; i < length; i++) {
+        if (pqInsert(pq, (PQElement) &keys[i], (PQElementPriority) &keys[i]) != PQ_SUCCESS) {
+            pqDestroy(pq);
+            return -1;
+        }
+    }
+    clock_t end = clock();
+    pqDestroy(pq);
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / length;
+}
+
+int main(int argc, char *argv[]) {
+    int length = argc > 1 ? atoi(argv[1]) : DEFAULT_TRACE_LENGTH;
+    if (length <= 0) {
+        fprintf(stderr, "usage: %s [number of elements]\n", argv[0]);
+        return 1;
+    }
+    int *keys = malloc(sizeof(*keys) * length);
+    if (!keys) {
+        return 1;
+    }
+    srand(0);
+    printf("%d inserts, ns per insert\n", length);
+    printf("%-15s", "trace");
+    for (unsigned b = 0; b < NUMBER_BACKENDS; b++) {
+        printf("%15s", backends[b].name);
+    }
+    printf("\n");
+    for (unsigned t = 0; t < NUMBER_TRACES; t++) {
+        traces[t].fill(keys, length);
+        printf("%-15s", traces[t].name);
+        for (unsigned b = 0; b < NUMBER_BACKENDS; b++) {
+            printf("%15.1f", timeInserts(backends[b].backend, keys, length));
+        }
+        printf("\n");
+    }
+    free(keys);
+    return 0;
+}
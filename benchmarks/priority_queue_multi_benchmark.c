@@ -0,0 +1,230 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "../priority_queue.h"
+#include "../priority_queue_concurrent.h"
+#include "../priority_queue_multi.h"
+
+/**
+* Measures the multi priority queue in two ways:
+*   Throughput - every thread alternates inserting an element with a random priority and
+*       popping, next to the exact concurrent priority queue. The multi priority queue has
+*       QUEUES_PER_THREAD internal queues per thread.
+*   Rank error - how far from the first element the popped elements are, for a growing
+*       number of internal queues. The queue is filled with distinct priorities and then
+*       emptied by one thread, and the rank of every popped element among the elements
+*       left is counted: 0 is the first element, as an exact priority queue pops.
+*
+* Usage: priority_queue_multi_benchmark [max threads] [operations per thread]
+*/
+
+#define DEFAULT_MAX_THREADS 8
+#define DEFAULT_OPERATIONS 200000
+#define PREFILL 100000
+#define PRIORITY_RANGE 1000000
+#define QUEUES_PER_THREAD 4
+#define RANK_ERROR_ELEMENTS 100000
+#define MAX_RANK_ERROR_QUEUES 64
+
+static PQElement copyInt(PQElement n) {
+    int *copy = malloc(sizeof(*copy));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *(int *) n;
+    return copy;
+}
+
+static void freeInt(PQElement n) {
+    free(n);
+}
+
+static int compareEarlierFirst(PQElementPriority n1, PQElementPriority n2) {
+    return *(int *) n2 - *(int *) n1;
+}
+
+//xorshift, so the threads do not share the state of rand
+static int nextRandom(unsigned *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return (int) (*state % PRIORITY_RANGE);
+}
+
+typedef struct {
+    ConcurrentPriorityQueue cpq;
+    MultiPriorityQueue mpq;
+    int operations;
+    unsigned seed;
+} Worker;
+
+static void *concurrentWorker(void *argument) {
+    Worker *worker = argument;
+    for (int i = 0; i < worker->operations; i++) {
+        int key = nextRandom(&worker->seed);
+        cpqInsert(worker->cpq, &key, &key);
+        cpqPopFirst(worker->cpq, NULL, NULL);
+    }
+    return NULL;
+}
+
+static void *multiWorker(void *argument) {
+    Worker *worker = argument;
+    for (int i = 0; i < worker->operations; i++) {
+        int key = nextRandom(&worker->seed);
+        mpqInsert(worker->mpq, &key, &key);
+        mpqPopFirst(worker->mpq, NULL, NULL);
+    }
+    return NULL;
+}
+
+static double secondsSince(const struct timespec *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double) (end.tv_sec - start->tv_sec) + (double) (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+//returns the millions of operations (an insert or a pop) per second, negative on failure
+static double timeWorkers(void *(*work)(void *), Worker *workers, int threads) {
+    pthread_t ids[threads];
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    while (started < threads && pthread_create(&ids[started], NULL, work, &workers[started]) == 0) {
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    double seconds = secondsSince(&start);
+    if (started < threads) {
+        return -1;
+    }
+    return 2.0 * workers[0].operations * threads / seconds / 1e6;
+}
+
+static double timeConcurrent(int threads, int operations) {
+    ConcurrentPriorityQueue cpq = cpqCreate(copyInt, freeInt, copyInt, freeInt, compareEarlierFirst);
+    if (!cpq) {
+        return -1;
+    }
+    unsigned seed = 1;
+    for (int i = 0; i < PREFILL; i++) {
+        int key = nextRandom(&seed);
+        cpqInsert(cpq, &key, &key);
+    }
+    Worker workers[threads];
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (Worker) {cpq, NULL, operations, (unsigned) i + 2};
+    }
+    double throughput = timeWorkers(concurrentWorker, workers, threads);
+    cpqDestroy(cpq);
+    return throughput;
+}
+
+static double timeMulti(int threads, int operations) {
+    MultiPriorityQueue mpq = mpqCreate(QUEUES_PER_THREAD * threads, copyInt, freeInt, copyInt, freeInt,
+                                       compareEarlierFirst);
+    if (!mpq) {
+        return -1;
+    }
+    unsigned seed = 1;
+    for (int i = 0; i < PREFILL; i++) {
+        int key = nextRandom(&seed);
+        mpqInsert(mpq, &key, &key);
+    }
+    Worker workers[threads];
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (Worker) {NULL, mpq, operations, (unsigned) i + 2};
+    }
+    double throughput = timeWorkers(multiWorker, workers, threads);
+    mpqDestroy(mpq);
+    return throughput;
+}
+
+//Fenwick tree over the priorities 0..RANK_ERROR_ELEMENTS-1, counts the ones still in the queue
+static void countKey(int *tree, int key, int delta) {
+    for (int i = key + 1; i <= RANK_ERROR_ELEMENTS; i += i & -i) {
+        tree[i] += delta;
+    }
+}
+
+//returns how many of the keys still in the queue are smaller than key, so come before it
+static int countSmaller(const int *tree, int key) {
+    int count = 0;
+    for (int i = key; i > 0; i -= i & -i) {
+        count += tree[i];
+    }
+    return count;
+}
+
+//pops everything from a filled queue, stores the mean and the largest rank of the popped elements
+static bool measureRankError(int queue_count, double *mean, int *max) {
+    MultiPriorityQueue mpq = mpqCreate(queue_count, copyInt, freeInt, copyInt, freeInt, compareEarlierFirst);
+    int *keys = malloc(sizeof(*keys) * RANK_ERROR_ELEMENTS);
+    int *tree = calloc(RANK_ERROR_ELEMENTS + 1, sizeof(*tree));
+    bool ok = mpq && keys && tree;
+    for (int i = 0; ok && i < RANK_ERROR_ELEMENTS; i++) {
+        keys[i] = i;
+    }
+    //a random permutation of the priorities, so they are distinct
+    for (int i = RANK_ERROR_ELEMENTS - 1; ok && i > 0; i--) {
+        int j = rand() % (i + 1);
+        int swap = keys[i];
+        keys[i] = keys[j];
+        keys[j] = swap;
+    }
+    for (int i = 0; ok && i < RANK_ERROR_ELEMENTS; i++) {
+        ok = mpqInsert(mpq, &keys[i], &keys[i]) == PQ_SUCCESS;
+        countKey(tree, keys[i], 1);
+    }
+    long long total = 0;
+    *max = 0;
+    for (int i = 0; ok && i < RANK_ERROR_ELEMENTS; i++) {
+        PQElement popped = NULL;
+        ok = mpqPopFirst(mpq, &popped, NULL) == PQ_SUCCESS;
+        if (ok) {
+            int key = *(int *) popped;
+            int rank = countSmaller(tree, key);
+            countKey(tree, key, -1);
+            total += rank;
+            *max = rank > *max ? rank : *max;
+            free(popped);
+        }
+    }
+    *mean = (double) total / RANK_ERROR_ELEMENTS;
+    mpqDestroy(mpq);
+    free(keys);
+    free(tree);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+    int operations = argc > 2 ? atoi(argv[2]) : DEFAULT_OPERATIONS;
+    if (max_threads <= 0 || operations <= 0) {
+        fprintf(stderr, "usage: %s [max threads] [operations per thread]\n", argv[0]);
+        return 1;
+    }
+    printf("%d insert and pop pairs per thread on %d elements, millions of operations per second\n",
+           operations, PREFILL);
+    printf("%-10s%20s%20s\n", "threads", "concurrent heap", "multi queue");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        printf("%-10d%20.2f%20.2f\n", threads, timeConcurrent(threads, operations), timeMulti(threads, operations));
+    }
+    srand(0);
+    printf("\nrank error of %d pops\n", RANK_ERROR_ELEMENTS);
+    printf("%-10s%15s%15s\n", "queues", "mean", "max");
+    for (int queues = 1; queues <= MAX_RANK_ERROR_QUEUES; queues *= 2) {
+        double mean = 0;
+        int max = 0;
+        if (!measureRankError(queues, &mean, &max)) {
+            printf("%-10d%15s\n", queues, "failed");
+            continue;
+        }
+        printf("%-10d%15.2f%15d\n", queues, mean, max);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../priority_queue.h"
+
+/**
+* Measures the backends on a simulated year of scheduling, the way the event manager uses
+* its events queue. Every day a number of events are scheduled, mostly within the next
+* month and some up to a year ahead, and then every event that is due is popped.
+* Priorities are day numbers, so many events share a day. Elements and priorities are
+* copied, as the event manager copies its events and dates.
+* The list backend is only measured up to LIST_MAX_EVENTS_PER_DAY, it takes minutes beyond.
+*
+* Usage: priority_queue_radix_benchmark [most events per day]
+*/
+
+#define DEFAULT_MAX_EVENTS_PER_DAY 10000
+#define MIN_EVENTS_PER_DAY 10
+#define EVENTS_STEP 10
+#define LIST_MAX_EVENTS_PER_DAY 1000
+#define DAYS_IN_YEAR 360
+#define NEAR_DAYS 30
+#define FAR_PERCENT 10
+
+static PQElement copyInt(PQElement n) {
+    int *copy = malloc(sizeof(*copy));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *(int *) n;
+    return copy;
+}
+
+static void freeInt(PQElement n) {
+    free(n);
+}
+
+static bool equalInts(PQElement n1, PQElement n2) {
+    return *(int *) n1 == *(int *) n2;
+}
+
+static int compareEarlierFirst(PQElementPriority n1, PQElementPriority n2) {
+    return *(int *) n2 - *(int *) n1;
+}
+
+static long dayKey(PQElementPriority day) {
+    return *(int *) day;
+}
+
+typedef struct {
+    const char *name;
+    PQBackend backend;
+    int max_events_per_day;
+} Backend;
+
+static const Backend backends[] = {
+        {"list",        PQ_BACKEND_LIST,        LIST_MAX_EVENTS_PER_DAY},
+        {"binary heap", PQ_BACKEND_BINARY_HEAP, DEFAULT_MAX_EVENTS_PER_DAY * EVENTS_STEP},
+        {"skiplist",    PQ_BACKEND_SKIPLIST,    DEFAULT_MAX_EVENTS_PER_DAY * EVENTS_STEP},
+        {"radix heap",  PQ_BACKEND_RADIX_HEAP,  DEFAULT_MAX_EVENTS_PER_DAY * EVENTS_STEP},
+        {"calendar",    PQ_BACKEND_CALENDAR_QUEUE, DEFAULT_MAX_EVENTS_PER_DAY * EVENTS_STEP}
+};
+
+#define NUMBER_BACKENDS (sizeof(backends) / sizeof(*backends))
+
+//returns how many days from today an event is scheduled
+static int randomOffset(void) {
+    if (rand() % 100 < FAR_PERCENT) {
+        return 1 + rand() % DAYS_IN_YEAR;
+    }
+    return 1 + rand() % NEAR_DAYS;
+}
+
+//returns the average time of scheduling and popping one event in nanoseconds, negative on failure
+static double timeYear(PQBackend backend, int events_per_day) {
+    PriorityQueue pq = pqCreateKeyed(backend, copyInt, freeInt, equalInts, NULL, copyInt, freeInt,
+                                     compareEarlierFirst, dayKey);
+    if (!pq) {
+        return -1;
+    }
+    srand(0);
+    long long events = 0;
+    clock_t start = clock();
+    for (int today = 0; today < DAYS_IN_YEAR; today++) {
+        for (int i = 0; i < events_per_day; i++) {
+            int day = today + randomOffset();
+            if (pqInsert(pq, &i, &day) != PQ_SUCCESS) {
+                pqDestroy(pq);
+                return -1;
+            }
+        }
+        events += events_per_day;
+        //the events of the next day are due
+        PQElement first = NULL;
+        PQElementPriority first_day = NULL;
+        while (pqPeekTopK(pq, 1, &first, &first_day) == 1 && *(int *) first_day <= today + 1) {
+            pqRemove(pq);
+        }
+    }
+    clock_t end = clock();
+    pqDestroy(pq);
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / events;
+}
+
+int main(int argc, char *argv[]) {
+    int max_events = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_EVENTS_PER_DAY;
+    if (max_events < MIN_EVENTS_PER_DAY) {
+        fprintf(stderr, "usage: %s [most events per day, at least %d]\n", argv[0], MIN_EVENTS_PER_DAY);
+        return 1;
+    }
+    printf("a year of %d days, ns per scheduled and popped event\n%-15s", DAYS_IN_YEAR, "events per day");
+    for (unsigned b = 0; b < NUMBER_BACKENDS; b++) {
+        printf("%15s", backends[b].name);
+    }
+    printf("\n");
+    for (int events_per_day = MIN_EVENTS_PER_DAY; events_per_day <= max_events; events_per_day *= EVENTS_STEP) {
+        printf("%-15d", events_per_day);
+        for (unsigned b = 0; b < NUMBER_BACKENDS; b++) {
+            if (events_per_day > backends[b].max_events_per_day) {
+                printf("%15s", "-");
+                continue;
+            }
+            printf("%15.1f", timeYear(backends[b].backend, events_per_day));
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../priority_queue.h"
+#include "../priority_queue_typed.h"
+
+/**
+* Compares the generic binary heap queue to a PQ_DEFINE queue of ints: the same random
+* priorities are inserted into each, and then all of them are popped.
+*
+* Usage: priority_queue_typed_benchmark [number of elements]
+*/
+
+#define DEFAULT_TRACE_LENGTH 200000
+
+PQ_DEFINE(IntPQ, int, int, (a > b) - (a < b))
+
+static PQElement copyInt(PQElement n) {
+    int *copy = malloc(sizeof(*copy));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *(int *) n;
+    return copy;
+}
+
+static void freeInt(PQElement n) {
+    free(n);
+}
+
+static bool equalInts(PQElement n1, PQElement n2) {
+    return *(int *) n1 == *(int *) n2;
+}
+
+static int compareInts(PQElementPriority n1, PQElementPriority n2) {
+    int a = *(int *) n1, b = *(int *) n2;
+    return (a > b) - (a < b);
+}
+
+//both return the time of every insertion and removal, in nanoseconds per operation, negative on failure
+static double timeGeneric(const int *keys, int length) {
+    PriorityQueue pq = pqCreateWithBackend(PQ_BACKEND_BINARY_HEAP, copyInt, freeInt, equalInts, copyInt, freeInt,
+                                           compareInts);
+    if (!pq) {
+        return -1;
+    }
+    clock_t start = clock();
+    for (int i = 0; i < length; i++) {
+        if (pqInsert(pq, (PQElement) &keys[i], (PQElementPriority) &keys[i]) != PQ_SUCCESS) {
+            pqDestroy(pq);
+            return -1;
+        }
+    }
+    for (int i = 0; i < length; i++) {
+        pqRemove(pq);
+    }
+    clock_t end = clock();
+    pqDestroy(pq);
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / (2.0 * length);
+}
+
+static double timeTyped(const int *keys, int length) {
+    IntPQ pq = IntPQCreate();
+    if (!pq) {
+        return -1;
+    }
+    clock_t start = clock();
+    for (int i = 0; i < length; i++) {
+        if (IntPQInsert(pq, keys[i], keys[i]) != PQ_SUCCESS) {
+            IntPQDestroy(pq);
+            return -1;
+        }
+    }
+    for (int i = 0; i < length; i++) {
+        IntPQRemove(pq);
+    }
+    clock_t end = clock();
+    IntPQDestroy(pq);
+    return (double) (end - start) / CLOCKS_PER_SEC * 1e9 / (2.0 * length);
+}
+
+int main(int argc, char *argv[]) {
+    int length = argc > 1 ? atoi(argv[1]) : DEFAULT_TRACE_LENGTH;
+    if (length <= 0) {
+        fprintf(stderr, "usage: %s [number of elements]\n", argv[0]);
+        return 1;
+    }
+    int *keys = malloc(sizeof(*keys) * length);
+    if (!keys) {
+        return 1;
+    }
+    srand(0);
+    for (int i = 0; i < length; i++) {
+        keys[i] = rand();
+    }
+    double generic = timeGeneric(keys, length);
+    double typed = timeTyped(keys, length);
+    printf("%d inserts and removals, ns per operation\n", length);
+    printf("%-25s%10.1f\n", "generic binary heap", generic);
+    printf("%-25s%10.1f\n", "PQ_DEFINE", typed);
+    printf("%-25s%10.1fx\n", "speedup", generic / typed);
+    free(keys);
+    return 0;
+}
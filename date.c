@@ -4,31 +4,37 @@
 
 #define DAYS_IN_MONTH 30
 #define MONTHS_IN_YEAR 12
+#define DAYS_IN_YEAR (DAYS_IN_MONTH * MONTHS_IN_YEAR)
+//The first and last values of legal dates
+#define MIN_VALUE ((DateValue) -DATE_MAX_YEAR * DAYS_IN_YEAR)
+#define MAX_VALUE ((DateValue) DATE_MAX_YEAR * DAYS_IN_YEAR + DAYS_IN_YEAR - 1)
 
 //Returns boolean value indicating if the date params are valid
 static bool isDateValid(int day, int month, int year);
 
 struct Date_t
 {
-	int day;
-	int month;
-	int year;
+	DateValue value;
 };
 
 Date dateCreate(int day, int month, int year)
 {
-	if(!isDateValid(day, month, year))
+	DateValue value;
+	if(!dateValueMake(day, month, year, &value))
 	{
 		return NULL;
 	}
+	return dateCreateFromValue(value);
+}
+
+Date dateCreateFromValue(DateValue value)
+{
 	Date date = (Date) malloc(sizeof(*date));
 	if(!date)
 	{
 		return NULL;
 	}
-	date->day = day;
-	date->month = month;
-	date->year = year;
+	date->value = value;
 	return date;
 }
 
@@ -43,6 +49,10 @@ static bool isDateValid(int day, int month, int year)
     {
         return false;
     }
+    if(year < -DATE_MAX_YEAR || year > DATE_MAX_YEAR)
+    {
+        return false;
+    }
     return true;
 
 }
@@ -62,20 +72,17 @@ Date dateCopy(Date date)
     {
         return NULL;
     }
-    return dateCreate(date->day, date->month, date->year);
+    return dateCreateFromValue(date->value);
 }
 
 
 bool dateGet(Date date, int* day, int* month, int* year)
 {
-	if(!date || !day || !month || !year)
+	if(!date)
 	{
 		return false;
 	}
-	*day = date->day;
-	*month = date->month;
-	*year = date->year;
-	return true;
+	return dateValueGet(date->value, day, month, year);
 }
 
 int dateCompare(Date date1, Date date2)
@@ -84,39 +91,82 @@ int dateCompare(Date date1, Date date2)
     {
         return 0;
     }
-	int year_delta = date1->year - date2->year;
-	int month_delta = date1->month - date2->month;
-	int day_delta = date1->day - date2->day;
-	if(year_delta != 0)
+    return dateValueCompare(date1->value, date2->value);
+}
+
+void dateTick(Date date)
+{
+	if(!date)
 	{
-		return year_delta;
+		return;
 	}
-	if(month_delta != 0)
+	date->value = dateValueTick(date->value);
+}
+
+bool dateAddDays(Date date, int days)
+{
+	if(!date)
 	{
-		return month_delta;
+		return false;
 	}
-    return day_delta;
+	return dateValueAddDays(&date->value, days);
 }
 
-void dateTick(Date date)
+int dateDiffDays(Date date1, Date date2)
 {
-	if(!date)
+    if(!date1 || !date2)
+    {
+        return 0;
+    }
+    return dateValueDiffDays(date1->value, date2->value);
+}
+
+bool dateGetValue(Date date, DateValue* value)
+{
+	if(!date || !value)
 	{
-		return;
+		return false;
 	}
-	if(date->day < DAYS_IN_MONTH)
+	*value = date->value;
+	return true;
+}
+
+bool dateValueMake(int day, int month, int year, DateValue* value)
+{
+	if(!value || !isDateValid(day, month, year))
 	{
-		date->day++;
-		return;
+		return false;
 	}
-	if(date->month < MONTHS_IN_YEAR)
+	*value = (DateValue) year * DAYS_IN_YEAR + (month - 1) * DAYS_IN_MONTH + (day - 1);
+	return true;
+}
+
+bool dateValueGet(DateValue value, int* day, int* month, int* year)
+{
+	if(!day || !month || !year)
 	{
-		date->month++;
-		date->day = 1;
-		return;
+		return false;
 	}
-	date->year++;
-	date->month = 1;
-	date->day = 1;
-	return;
-}
\ No newline at end of file
+	//the year is rounded down, so the days into it are never negative
+	int years = value >= 0 ? value / DAYS_IN_YEAR : -((-value + DAYS_IN_YEAR - 1) / DAYS_IN_YEAR);
+	int day_of_year = value - years * DAYS_IN_YEAR;
+	*year = years;
+	*month = day_of_year / DAYS_IN_MONTH + 1;
+	*day = day_of_year % DAYS_IN_MONTH + 1;
+	return true;
+}
+
+bool dateValueAddDays(DateValue* value, int days)
+{
+	if(!value)
+	{
+		return false;
+	}
+	//every month has the same days, so moving a date is adding to its value. It only has to stay legal
+	if((days > 0 && days > MAX_VALUE - *value) || (days < 0 && days < MIN_VALUE - *value))
+	{
+		return false;
+	}
+	*value += days;
+	return true;
+}
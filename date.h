@@ -2,10 +2,21 @@
 #define DATE_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /** Type for defining the date */
 typedef struct Date_t *Date;
 
+/**
+* Type for a date held by value: the number of days since 1.1.0, negative before it. Values are
+* ordered like the dates they stand for, and the day after a date is its value plus one, so
+* comparing and ticking values is integer arithmetic and they are copied without allocating.
+*/
+typedef int32_t DateValue;
+
+/** Years of legal dates are between -DATE_MAX_YEAR and DATE_MAX_YEAR, so that any two values can be subtracted */
+#define DATE_MAX_YEAR 2000000
+
 /**
 * dateCreate: Allocates a new date.
 *
@@ -18,6 +29,16 @@ typedef struct Date_t *Date;
 */
 Date dateCreate(int day, int month, int year);
 
+/**
+* dateCreateFromValue: Allocates a new date with the day, month and year of a date value.
+*
+* @param value - the value of the date.
+* @return
+* 	NULL - if allocation failed.
+* 	A new Date in case of success.
+*/
+Date dateCreateFromValue(DateValue value);
+
 /**
 * dateDestroy: Deallocates an existing Date.
 *
@@ -67,4 +88,108 @@ int dateCompare(Date date1, Date date2);
 */
 void dateTick(Date date);
 
+/**
+* dateAddDays: moves the date by a number of days in O(1), without ticking it day by day.
+*
+* @param date - Target Date
+* @param days - the days to move the date by, back if negative.
+*
+* @return
+* 	false if date is NULL or the new date would be illegal, the date is left as it was.
+* 	Otherwise true.
+*/
+bool dateAddDays(Date date, int days);
+
+/**
+* dateDiffDays: returns the number of days from date2 to date1
+*
+* @return
+* 		A negative number if date1 occurs first;
+* 		0 if they're equal or one of the given dates is NULL;
+*		A positive number if date1 arrives after date2.
+*/
+int dateDiffDays(Date date1, Date date2);
+
+/**
+* dateGetValue: Returns the value of a date
+*
+* @param date - Target Date
+* @param value - the pointer to assign the value of the date into.
+*
+* @return
+* 	false if one of pointers is NULL.
+* 	Otherwise true and the value is assigned to the pointer.
+*/
+bool dateGetValue(Date date, DateValue* value);
+
+/**
+* dateValueMake: Packs a day, month and year into a date value.
+*
+* @param day - the day of the date.
+* @param month - the month of the date.
+* @param year - the year of the date.
+* @param value - the pointer to assign the value of the date into.
+* @return
+* 	false - if value is NULL or the date is illegal.
+* 	Otherwise true and the value is assigned to the pointer.
+*/
+bool dateValueMake(int day, int month, int year, DateValue* value);
+
+/**
+* dateValueGet: Returns the day, month and year of a date value
+*
+* @param value - the value of the date.
+* @param day - the pointer to assign to day of the date into.
+* @param month - the pointer to assign to month of the date into.
+* @param year - the pointer to assign to year of the date into.
+*
+* @return
+* 	false if one of pointers is NULL.
+* 	Otherwise true and the date is assigned to the pointers.
+*/
+bool dateValueGet(DateValue value, int* day, int* month, int* year);
+
+/**
+* dateValueCompare: compares to date values and return which comes first
+*
+* @return
+* 		A negative integer if value1 occurs first;
+* 		0 if they're equal;
+*		A positive integer if value1 arrives after value2.
+*/
+static inline int dateValueCompare(DateValue value1, DateValue value2)
+{
+    return value1 - value2;
+}
+
+/**
+* dateValueTick: Returns the value of the day after a date value.
+*
+* @param value - the value of the date.
+*/
+static inline DateValue dateValueTick(DateValue value)
+{
+    return value + 1;
+}
+
+/**
+* dateValueAddDays: moves a date value by a number of days.
+*
+* @param value - the pointer to the value of the date.
+* @param days - the days to move the date by, back if negative.
+*
+* @return
+* 	false if value is NULL or the new date would be illegal, the value is left as it was.
+* 	Otherwise true.
+*/
+bool dateValueAddDays(DateValue* value, int days);
+
+/**
+* dateValueDiffDays: returns the number of days from value2 to value1, negative if value1 occurs first
+*/
+static inline int dateValueDiffDays(DateValue value1, DateValue value2)
+{
+    return value1 - value2;
+}
+
 #endif //DATE_H_
@@ -2,11 +2,20 @@
 #include <string.h>
 #include <assert.h>
 #include <stdio.h>
+#include <stdint.h>
 
 #include "event_manager.h"
 #include "date.h"
 #include "priority_queue.h"
 
+//The backend of the events pq. Dates only move forward and cluster in the next months, so
+//PQ_BACKEND_CALENDAR_QUEUE suits it too, and PQ_BACKEND_RADIX_HEAP as long as events are rarely added
+//before the first one
+#ifndef EM_EVENTS_BACKEND
+#define EM_EVENTS_BACKEND PQ_BACKEND_SKIPLIST
+#endif
+
+
 //Enum for indicating if we want to remove or add an event to a member in em
 typedef enum {MEMBER_ADD_EVENT, MEMBER_REMOVE_EVENT} memberEnum;
 typedef struct Member_t
@@ -14,36 +23,44 @@ typedef struct Member_t
     int id;
     char *name;
 	int events_number; //matters only in members pq
+    PQHandle handle; //matters only in members pq, the member's handle there
 }*Member;
 
 typedef struct Event_t
 {
-    Date date;
+    DateValue date;
     int id;
     char *name;
     PriorityQueue member_pq; 
+    PQHandle handle; //the event's handle in em->events
 }*Event;
 
 struct EventManager_t
 {
-    Date current_date;
+    DateValue current_date;
     PriorityQueue events;
 	PriorityQueue members;
 };
 
-//Copy an int t a new memory
-static PQElementPriority copyIdGeneric(PQElementPriority n);
-
-//Free int's memory
-static void freeIdGeneric(PQElementPriority n);
-
 //Compare 2 ints
 static int compareIdsGeneric(PQElementPriority n1, PQElementPriority n2);
 
+//Hash a member by its id
+static unsigned long memberHash(PQElement member);
+
+//Hash a reference to a member, as kept in an event's members pq, by the member's id
+static unsigned long memberRefHash(PQElement member_ref);
+
+//Hash an event by its id
+static unsigned long eventHash(PQElement event);
+
 
 //Bool indicating if two memers are equal (Chekck by id)
 static bool membersEqual(PQElement member1, PQElement member2);
 
+//Bool indicating if two references to members refer to equal members
+static bool memberRefsEqual(PQElement member_ref1, PQElement member_ref2);
+
 //Copy a member's memory toa new member
 static PQElement memberCopy(PQElement member);
 
@@ -55,10 +72,10 @@ static void memberFree(PQElement member);
 
 
 //Create an event with given date id and name
-static Event eventCreate(Date date, int id, char* name);
+static Event eventCreate(DateValue date, int id, char* name);
 
 //Create an event with given date, id, name and make it's member pq point to null
-static Event eventCreateNullPQ(Date date, int id, char* name);
+static Event eventCreateNullPQ(DateValue date, int id, char* name);
 
 //Create an event only with the diven id.
 static Event createBlankEvent(int id);
@@ -77,10 +94,11 @@ static bool eventsEqual(PQElement event1, PQElement event2);
 static bool eventNameAndDateinEM(EventManager em, Event event);
 
 //Checks if em has an event with the given name and date
-static bool nameAndDateinEMEvent(EventManager em, char *name, Date date);
+static bool nameAndDateinEMEvent(EventManager em, char *name, DateValue date);
 
-//Add the event with the given date as the priority to em
-static EventManagerResult emEventAdd(EventManager em, Event event, Date date);
+//Add the event to em, its date is its priority. On success em owns the event, otherwise it still belongs
+//to the caller
+static EventManagerResult emEventAdd(EventManager em, Event event);
 
 //Find an event with given id in em. If the event is found PQ_SUCCESS is returned and the Event pointed to by event_p is
 //the event found
@@ -90,9 +108,12 @@ static EventManagerResult emFindEvent(EventManager em, int id, Event *event_p);
 //the member found
 static EventManagerResult emFindMember(EventManager em, int id, Member *member_p);
 
-//Removes all members currently linked to an event from the event
+//Removes all members currently linked to an event from the event. The event doesn't have to be in em
 static EventManagerResult emRemoveAllMembersFromEvent(EventManager em, Event event);
 
+//Removes every event that is before em's current date, along with its links to members
+static EventManagerResult emExpireEvents(EventManager em);
+
 //Change the amount of the events linked to a member with member_id in em.
 //The enum indicates if we want to add or remove an event to the member
 static EventManagerResult emMemberChangePriority(EventManager em, int member_id, memberEnum add_or_remove);
@@ -105,42 +126,79 @@ static int compareMemberPriority(PQElement memberA, PQElement memberB);
 static void emPrintEvent(Event event, FILE* stream);
 
 //Static function for printing the date's stats to the stream file
-static void printDate(Date date, FILE* stream);
+static void printDate(DateValue date, FILE* stream);
 
 //Static function for printing the pq of members linked to an event
 static void printEventMemberPq(PriorityQueue members, FILE* stream);
 
+//The events pq keeps dates inside its priority pointers, so they are copied and freed without allocating.
+//The pointers are odd, so no date is a NULL priority
+static PQElementPriority datePriority(DateValue date);
+
+//Returns the date kept in a priority of the events pq
+static DateValue priorityDate(PQElementPriority priority);
+
+//Copying and freeing a priority of the events pq, there is nothing to allocate or free
+static PQElementPriority datePriorityCopy(PQElementPriority priority);
+static void datePriorityFree(PQElementPriority priority);
+
 //Compare dates backwards
-static int dateCompareEarliestFirst(Date date1, Date date2);
+static int dateCompareEarliestFirst(PQElementPriority date1, PQElementPriority date2);
 
-static int dateCompareEarliestFirst(Date date1, Date date2)
+//Maps a date to the key the events pq orders it by, when its backend needs one
+static long dateKey(PQElementPriority date);
+
+static PQElementPriority datePriority(DateValue date)
 {
-    return -dateCompare(date1, date2);
+    return (PQElementPriority) (2 * (intptr_t) date + 1);
 }
-static PQElementPriority copyIdGeneric(PQElementPriority n) 
+
+static DateValue priorityDate(PQElementPriority priority)
 {
-    if (!n) {
-        return NULL;
-    }
-    int *copy = malloc(sizeof(*copy));
-    if (!copy) {
-        return NULL;
-    }
-    *copy = *(int *) n;
-    return copy;
+    return (DateValue) (((intptr_t) priority - 1) / 2);
+}
+
+static PQElementPriority datePriorityCopy(PQElementPriority priority)
+{
+    return priority;
 }
 
-static void freeIdGeneric(PQElementPriority n) 
+static void datePriorityFree(PQElementPriority priority)
 {
-    free(n);
+    (void) priority;
 }
 
+static int dateCompareEarliestFirst(PQElementPriority date1, PQElementPriority date2)
+{
+    return -dateValueCompare(priorityDate(date1), priorityDate(date2));
+}
+
+//Earlier dates get smaller keys, the date values already do
+static long dateKey(PQElementPriority date)
+{
+    return priorityDate(date);
+}
 static int compareIdsGeneric(PQElementPriority n1, PQElementPriority n2) 
 {
     return -(*(int *) n1 - *(int *) n2);
 }
 
-static Event eventCreate(Date date, int id, char* name)
+static unsigned long memberHash(PQElement member)
+{
+    return (unsigned long) ((Member) member)->id;
+}
+
+static unsigned long memberRefHash(PQElement member_ref)
+{
+    return memberHash(*(Member*) member_ref);
+}
+
+static unsigned long eventHash(PQElement event)
+{
+    return (unsigned long) ((Event) event)->id;
+}
+
+static Event eventCreate(DateValue date, int id, char* name)
 {
 	if(!name)
 	{
@@ -158,26 +216,22 @@ static Event eventCreate(Date date, int id, char* name)
 		return NULL;
 	}
 	strcpy(event->name, name);
-	PriorityQueue pq = pqCreate(memberCopy, memberFree, membersEqual, 
-					copyIdGeneric, freeIdGeneric, compareIdsGeneric);
+    //the members are owned by em->members, an event only keeps references to them, next to their ids
+	PriorityQueue pq = pqCreateInline(sizeof(Member), sizeof(int), PQ_BACKEND_LIST, memberRefsEqual, memberRefHash,
+					compareIdsGeneric);
 	if(!pq)
 	{
         eventDestroy(event);
 		return NULL;
 	}
     event->member_pq = pq;
-    Date date_copy = dateCopy(date);
-    if(!date_copy)
-    {
-        eventDestroy(event);
-        return NULL;
-    }
-    event->date = date_copy;
+    event->handle = NULL;
+    event->date = date;
     event->id = id;
 	return event;
 }
 
-static Event eventCreateNullPQ(Date date, int id, char* name)
+static Event eventCreateNullPQ(DateValue date, int id, char* name)
 {
 	if(!name)
 	{
@@ -196,14 +250,9 @@ static Event eventCreateNullPQ(Date date, int id, char* name)
 	}
 	strcpy(event->name, name);
 
-    Date date_copy = dateCopy(date);
-    if(!date_copy)
-    {
-        eventDestroy(event);
-        return NULL;
-    }
     event->member_pq = NULL;
-    event->date = date_copy;
+    event->handle = NULL;
+    event->date = date;
     event->id = id;
 	return event;
 }
@@ -217,7 +266,8 @@ static Event createBlankEvent(int id)
     }
     event->id = id;
     event->member_pq = NULL;
-    event->date = NULL;
+    event->handle = NULL;
+    event->date = 0;
     event->name = NULL;
     return event;
 }
@@ -252,7 +302,6 @@ static void eventDestroy(PQElement event)
 {
     Event new_event = (Event) event;
     pqDestroy(new_event->member_pq);
-	dateDestroy(new_event->date);
     free(new_event->name);
     free(new_event);
 }
@@ -306,6 +355,7 @@ static Member memberCreate(int id, char *name)
     strcpy(member->name, name);
     member->id = id;
 	member->events_number = 0;
+    member->handle = NULL;
     return (PQElement) member;
 }
 
@@ -343,6 +393,11 @@ static bool membersEqual(PQElement member1, PQElement member2)
     return new_member1->id == new_member2->id;
 }
 
+static bool memberRefsEqual(PQElement member_ref1, PQElement member_ref2)
+{
+    return membersEqual(*(Member*) member_ref1, *(Member*) member_ref2);
+}
+
 static void memberFree(PQElement member)
 {
     Member member_new = (Member) member;
@@ -362,22 +417,17 @@ EventManager createEventManager(Date date)
     {
         return NULL;
     }
-    em->current_date = dateCopy(date);
-    if(!em->current_date)
-    {
-        destroyEventManager(em);
-        return NULL;
-    }
-    em->events = pqCreate(eventCopy, eventDestroy, eventsEqual,
-						(PQElementPriority (*)(PQElementPriority)) dateCopy, 
-                        (void (*) (PQElementPriority)) dateDestroy,
-                        (int (*) (PQElementPriority, PQElementPriority)) dateCompareEarliestFirst);
+    dateGetValue(date, &em->current_date);
+    em->members = NULL;
+    //both queues are printed in order and change all the time, the skiplist does both without scanning
+    em->events = pqCreateKeyed(EM_EVENTS_BACKEND, eventCopy, eventDestroy, eventsEqual, eventHash,
+                               datePriorityCopy, datePriorityFree, dateCompareEarliestFirst, dateKey);
     if(!em->events)
     {
         destroyEventManager(em);
         return NULL;
     }
-    em->members = pqCreate(memberCopy, memberFree, membersEqual,
+    em->members = pqCreateHashed(PQ_BACKEND_SKIPLIST, memberCopy, memberFree, membersEqual, memberHash,
 							memberCopy, memberFree, compareMemberPriority);
 	if(!em->members)
 	{
@@ -393,7 +443,6 @@ void destroyEventManager(EventManager em)
 	{
 		return;
 	}
-	dateDestroy(em->current_date);
 	pqDestroy(em->events);
 	pqDestroy(em->members);
     free(em);
@@ -420,52 +469,52 @@ EventManagerResult emAddMember(EventManager em, char* member_name, int member_id
 		memberFree(new_member);
         return EM_MEMBER_ID_ALREADY_EXISTS;
     }
-    PriorityQueueResult pq_result = pqInsert(em->members, new_member, new_member);
+    //the member is its own priority, but the queue needs an object of its own for each
+    Member priority = memberCopy(new_member);
+    if(!priority)
+    {
+        memberFree(new_member);
+        return EM_OUT_OF_MEMORY;
+    }
+    PriorityQueueResult pq_result = pqInsertNoCopy(em->members, new_member, priority, &new_member->handle);
 	if(pq_result == PQ_OUT_OF_MEMORY)
 	{
 		memberFree(new_member);
+		memberFree(priority);
 		return EM_OUT_OF_MEMORY;
 	}
 	assert(pq_result == PQ_SUCCESS);
-	memberFree(new_member);
     return EM_SUCCESS;
 }
 
 static EventManagerResult emMemberChangePriority(EventManager em, int member_id, memberEnum add_or_remove)
 {
-	Member member_to_destroy = NULL;
-	emFindMember(em, member_id, &member_to_destroy);//member should exist 
-    Member member = (Member) memberCopy(member_to_destroy);
-	if(!member)
-	{
-		return EM_OUT_OF_MEMORY;
-	}
-    PriorityQueueResult result = pqRemoveElement(em->members, member_to_destroy);//delete the member in PQ
-    assert(result == PQ_SUCCESS);
-	assert(member->id == member_id);
+	Member member = NULL;
+	emFindMember(em, member_id, &member);//member should exist 
+	assert(member != NULL && member->id == member_id);
+    int old_number = member->events_number;
     int new_number;
 	switch(add_or_remove)
 	{
 		case MEMBER_ADD_EVENT:
-			new_number = member->events_number + 1;
+			new_number = old_number + 1;
             break;
 		case MEMBER_REMOVE_EVENT:
-			new_number = member->events_number - 1;
+			new_number = old_number - 1;
             break;
 		default:
 			assert(1 == 0);// I probably fucked up using the enum
 	};
-	member->events_number = new_number;
 	assert(0 <= new_number);
-    
-    result = pqInsert(em->members, member, member);
-	if(result == PQ_NULL_ARGUMENT)
+    //the member is its own priority: update the element in place and reposition it by the new count
+	member->events_number = new_number;
+    PriorityQueueResult result = pqChangePriorityByHandle(em->members, member->handle, member);
+	if(result == PQ_OUT_OF_MEMORY)
 	{
-        memberFree(member);
-		return EM_NULL_ARGUMENT;
+        member->events_number = old_number;
+		return EM_OUT_OF_MEMORY;
 	}
 	assert(result == PQ_SUCCESS);
-    memberFree(member);
 	return EM_SUCCESS;
 }
 
@@ -502,11 +551,11 @@ EventManagerResult emAddMemberToEvent(EventManager em, int member_id, int event_
     
     }
 	assert(result == EM_SUCCESS);
-    if(pqContains(event->member_pq, member))
+    if(pqContains(event->member_pq, &member))
     {
         return EM_EVENT_AND_MEMBER_ALREADY_LINKED;
     }
-	PriorityQueueResult pq_result = pqInsert(event->member_pq, member, &member->id);
+	PriorityQueueResult pq_result = pqInsert(event->member_pq, &member, &member->id);
     if(pq_result == PQ_OUT_OF_MEMORY)
 	{
 		return EM_OUT_OF_MEMORY;
@@ -554,11 +603,11 @@ EventManagerResult emRemoveMemberFromEvent(EventManager em, int member_id, int e
     }
 	assert(result == EM_SUCCESS);
 	
-    if(!pqContains(event->member_pq, member))
+    if(!pqContains(event->member_pq, &member))
     {
         return EM_EVENT_AND_MEMBER_NOT_LINKED;
     }
-	PriorityQueueResult pq_result = pqRemoveElement(event->member_pq, member);
+	PriorityQueueResult pq_result = pqRemoveElement(event->member_pq, &member);
     if(pq_result == PQ_OUT_OF_MEMORY)
     {
         return EM_OUT_OF_MEMORY;
@@ -577,7 +626,7 @@ static bool eventNameAndDateinEM(EventManager em, Event event)
 {
     PQ_FOREACH(Event, iterator_event, em->events)
     {
-        if(dateCompare(iterator_event->date, event->date) == 0 && strcmp(iterator_event->name, event->name) == 0)
+        if(dateValueCompare(iterator_event->date, event->date) == 0 && strcmp(iterator_event->name, event->name) == 0)
         {
             return true;
         }
@@ -585,18 +634,18 @@ static bool eventNameAndDateinEM(EventManager em, Event event)
     return false;
 }
 //like above but uses external date 
-static bool nameAndDateinEMEvent(EventManager em, char *name, Date date)
+static bool nameAndDateinEMEvent(EventManager em, char *name, DateValue date)
 {
     PQ_FOREACH(Event, iterator_event, em->events)
     {
-        if(dateCompare(iterator_event->date, date) == 0 && strcmp(iterator_event->name, name) == 0)
+        if(dateValueCompare(iterator_event->date, date) == 0 && strcmp(iterator_event->name, name) == 0)
         {
             return true;
         }
     }
     return false;
 }
-static EventManagerResult emEventAdd(EventManager em, Event event, Date date)
+static EventManagerResult emEventAdd(EventManager em, Event event)
 {
     if(eventNameAndDateinEM(em, event))
     {
@@ -607,7 +656,7 @@ static EventManagerResult emEventAdd(EventManager em, Event event, Date date)
         return EM_EVENT_ID_ALREADY_EXISTS;
     }
 
-    PriorityQueueResult pq_result = pqInsert(em->events, event, date);
+    PriorityQueueResult pq_result = pqInsertNoCopy(em->events, event, datePriority(event->date), &event->handle);
     //arguments cant be null because we already checked them
     assert(pq_result != PQ_NULL_ARGUMENT);
     switch(pq_result)
@@ -627,7 +676,9 @@ EventManagerResult emAddEventByDate(EventManager em, char* event_name, Date date
     {
         return EM_NULL_ARGUMENT;
     }
-    if(dateCompare(date, em->current_date) < 0)
+    DateValue date_value;
+    dateGetValue(date, &date_value);
+    if(dateValueCompare(date_value, em->current_date) < 0)
     {
         return EM_INVALID_DATE;
     }
@@ -637,14 +688,17 @@ EventManagerResult emAddEventByDate(EventManager em, char* event_name, Date date
         return EM_INVALID_EVENT_ID;
     }
 
-    Event event = eventCreate(date, event_id, event_name);
+    Event event = eventCreate(date_value, event_id, event_name);
     if(!event)
     {
         return EM_OUT_OF_MEMORY;
     }
 
-    EventManagerResult em_result = emEventAdd(em, event, date); 
-    eventDestroy(event);
+    EventManagerResult em_result = emEventAdd(em, event); 
+    if(em_result != EM_SUCCESS)
+    {
+        eventDestroy(event);
+    }
     return em_result;
 }
 
@@ -662,28 +716,23 @@ EventManagerResult emAddEventByDiff(EventManager em, char* event_name, int days,
     {
         return EM_INVALID_EVENT_ID;
     }
-    //copy current date so it won't change when we tick
-    Date new_date = dateCopy(em->current_date);
-    if(!new_date)
-    {
-        return EM_OUT_OF_MEMORY;
-    }
-    
-    for (int i = 0; i < days; i++)
+    DateValue new_date = em->current_date;
+    if(!dateValueAddDays(&new_date, days))
     {
-        dateTick(new_date);
+        return EM_INVALID_DATE;
     }
 
     Event event = eventCreate(new_date, event_id, event_name);
     if(!event)
     {
-        dateDestroy(new_date);
         return EM_OUT_OF_MEMORY;
     }
     
-    EventManagerResult em_result = emEventAdd(em, event, new_date);
-    dateDestroy(new_date);
-    eventDestroy(event);
+    EventManagerResult em_result = emEventAdd(em, event);
+    if(em_result != EM_SUCCESS)
+    {
+        eventDestroy(event);
+    }
     return em_result;
 }
 
@@ -693,20 +742,37 @@ static EventManagerResult emRemoveAllMembersFromEvent(EventManager em, Event eve
     {
         return EM_NULL_ARGUMENT;
     }
-    Member first = pqGetFirst(event->member_pq);
-    while(first)
+    PQCursor cursor;
+    PQ_CURSOR_FOREACH(Member*, member_ref, cursor, event->member_pq)
     {
-        EventManagerResult em_result = emRemoveMemberFromEvent(em, first->id, event->id);
+        EventManagerResult em_result = emMemberChangePriority(em, (*member_ref)->id, MEMBER_REMOVE_EVENT);
         if(em_result == EM_OUT_OF_MEMORY)
         {
             return EM_OUT_OF_MEMORY;
         }
         assert(em_result == EM_SUCCESS);
-        first = pqGetFirst(event->member_pq);
+        pqCursorRemoveCurrent(&cursor);
     }
     return EM_SUCCESS;
 }
 
+static EventManagerResult emExpireEvents(EventManager em)
+{
+    PQElement first = NULL;
+    int count = pqPeekTopK(em->events, 1, &first, NULL);
+    while(count == 1 && dateValueCompare(((Event) first)->date, em->current_date) < 0)
+    {
+        //the members are unlinked while the event is still in the pq, so running out of memory leaves it there
+        if(emRemoveAllMembersFromEvent(em, first) == EM_OUT_OF_MEMORY)
+        {
+            return EM_OUT_OF_MEMORY;
+        }
+        pqRemove(em->events);
+        count = pqPeekTopK(em->events, 1, &first, NULL);
+    }
+    return count < 0 ? EM_OUT_OF_MEMORY : EM_SUCCESS;
+}
+
 EventManagerResult emRemoveEvent(EventManager em, int event_id)
 {
     if(!em)
@@ -722,34 +788,24 @@ EventManagerResult emRemoveEvent(EventManager em, int event_id)
     {
         return EM_OUT_OF_MEMORY;
     }
-    bool event_found = false;
-    EventManagerResult em_result;
     //find event in pq to remove it's members
-    PQ_FOREACH(Event, iterator_event, em->events)
-    {
-        if(eventsEqual(iterator_event, event_to_remove))
-        {
-            em_result = emRemoveAllMembersFromEvent(em, iterator_event);
-            if(em_result == EM_OUT_OF_MEMORY)
-            {
-                eventDestroy(event_to_remove);
-                return EM_OUT_OF_MEMORY;
-            }
-            assert(em_result == EM_SUCCESS);
-            event_found = true;
-            break;
-        }
-    }
+    Event event_found = pqFind(em->events, event_to_remove);
     if(!event_found)
     {
         eventDestroy(event_to_remove);
         return EM_EVENT_NOT_EXISTS;
     }
+    EventManagerResult em_result = emRemoveAllMembersFromEvent(em, event_found);
+    if(em_result == EM_OUT_OF_MEMORY)
+    {
+        eventDestroy(event_to_remove);
+        return EM_OUT_OF_MEMORY;
+    }
     assert(em_result == EM_SUCCESS);
     PriorityQueueResult pq_result = pqRemoveElement(em->events, event_to_remove);
     eventDestroy(event_to_remove);
     assert(pq_result != PQ_NULL_ARGUMENT);    //we already checked for null args
-    //if the element does not exist we alresy know it from going over the pq
+    //if the element does not exist we alresy know it from looking it up
     assert(pq_result != PQ_ELEMENT_DOES_NOT_EXISTS);
     switch(pq_result)
     {
@@ -773,17 +829,14 @@ static EventManagerResult emFindEvent(EventManager em, int id, Event* event_p)
         return EM_OUT_OF_MEMORY;
     }
 
-    PQ_FOREACH(Event, iterator_event, em->events)
+    Event event = pqFind(em->events, blank_event);
+    eventDestroy(blank_event);
+    if(!event)
     {
-        if(eventsEqual(iterator_event, blank_event))
-        {
-            eventDestroy(blank_event);
-            *event_p = iterator_event;
-            return EM_SUCCESS;
-        }
+        return EM_EVENT_ID_NOT_EXISTS;
     }
-    eventDestroy(blank_event);
-    return EM_EVENT_ID_NOT_EXISTS;
+    *event_p = event;
+    return EM_SUCCESS;
 }
 
 static EventManagerResult emFindMember(EventManager em, int id, Member *member_p)
@@ -792,15 +845,15 @@ static EventManagerResult emFindMember(EventManager em, int id, Member *member_p
     {
         return EM_NULL_ARGUMENT;
     }
-    PQ_FOREACH(Member, iterator, em->members)
+    struct Member_t key;
+    key.id = id;
+    Member member = pqFind(em->members, &key);
+    if(!member)
     {
-        if(id == iterator->id)
-        {
-            *member_p = iterator;
-            return EM_SUCCESS;
-        }
+        return EM_MEMBER_ID_NOT_EXISTS;
     }
-    return EM_MEMBER_ID_NOT_EXISTS;
+    *member_p = member;
+    return EM_SUCCESS;
 }
 
 EventManagerResult emChangeEventDate(EventManager em, int event_id, Date new_date)
@@ -809,7 +862,9 @@ EventManagerResult emChangeEventDate(EventManager em, int event_id, Date new_dat
     {
         return EM_NULL_ARGUMENT;
     }
-    if(dateCompare(new_date, em->current_date) < 0)
+    DateValue date_value;
+    dateGetValue(new_date, &date_value);
+    if(dateValueCompare(date_value, em->current_date) < 0)
     {
         return EM_INVALID_DATE;
     }
@@ -824,33 +879,19 @@ EventManagerResult emChangeEventDate(EventManager em, int event_id, Date new_dat
         return em_result;
     }
     assert(em_result == EM_SUCCESS || em_result == EM_EVENT_ID_NOT_EXISTS || em_result == EM_OUT_OF_MEMORY);
-    if(nameAndDateinEMEvent(em, event_to_change->name, new_date))
+    if(nameAndDateinEMEvent(em, event_to_change->name, date_value))
     {
         return EM_EVENT_ALREADY_EXISTS;
     }
-    Date old_date = event_to_change->date;
-    PriorityQueueResult pq_result = pqChangePriority(em->events, event_to_change,
-    old_date, new_date);//change the date
+    PriorityQueueResult pq_result = pqChangePriorityByHandle(em->events, event_to_change->handle,
+                                                             datePriority(date_value));
     if(pq_result == PQ_OUT_OF_MEMORY)
     {
         return EM_OUT_OF_MEMORY;
     }
     assert(pq_result == PQ_SUCCESS);
-    //now we change the date in the event elemnt itself
-    event_to_change = NULL;
-    em_result = emFindEvent(em, event_id, &event_to_change);
-    if(em_result != EM_SUCCESS)
-    {
-        return em_result;
-    }
-    assert(em_result == EM_SUCCESS || em_result == EM_EVENT_ID_NOT_EXISTS || em_result == EM_OUT_OF_MEMORY);
-    dateDestroy(event_to_change->date);
-    Date date_copy = dateCopy(new_date);
-    if(!date_copy)
-    {
-        return EM_OUT_OF_MEMORY;
-    }
-    event_to_change->date = date_copy;
+    //the event keeps its node, so we change the date in the event element itself
+    event_to_change->date = date_value;
     return EM_SUCCESS;
 }
 
@@ -865,23 +906,16 @@ EventManagerResult emTick(EventManager em, int days)
     {
         return EM_INVALID_DATE;
     }
-    for(int i = 0; i < days; i++)
+    //the date jumps over all the days at once, and the events pq is ordered by date, so expiring once at the
+    //new date pops the same events as expiring every day on the way. A tick costs the events it expires,
+    //however many days it spans
+    if(!dateValueAddDays(&em->current_date, days))
     {
-        dateTick(em->current_date);
-        Event first = (Event) pqGetFirst(em->events);
-        while(first && dateCompare(first->date, em->current_date) < 0)
-        {
-            EventManagerResult em_result = emRemoveAllMembersFromEvent(em, first);
-            if(em_result == EM_OUT_OF_MEMORY)
-            {
-                return EM_OUT_OF_MEMORY;
-            }
-            assert(em_result == EM_SUCCESS);
-            pqRemove(em->events);
-            first = (Event) pqGetFirst(em->events);
-        }
+        return EM_INVALID_DATE;
     }
-    return EM_SUCCESS;
+    EventManagerResult em_result = emExpireEvents(em);
+    assert(em_result == EM_SUCCESS || em_result == EM_OUT_OF_MEMORY);
+    return em_result;
 }
 
 int emGetEventsAmount(EventManager em)
@@ -947,10 +981,10 @@ static void emPrintEvent(Event event, FILE* stream)
     fprintf(stream, "\n");
 }
 
-static void printDate(Date date, FILE* stream)
+static void printDate(DateValue date, FILE* stream)
 {
     int day, month, year;
-    dateGet(date, &day, &month, &year);
+    dateValueGet(date, &day, &month, &year);
     fprintf(stream, "%d.%d.%d", day, month, year);
 }
 
@@ -958,9 +992,9 @@ static void printEventMemberPq(PriorityQueue members, FILE* stream)
 {
     // int size = pqGetSize(members);
     // int memberCounter = 0;
-    PQ_FOREACH(Member, iterator_member, members)
+    PQ_FOREACH(Member*, iterator_member, members)
     {
         fprintf(stream, ",");
-        fprintf(stream, "%s", iterator_member->name);
+        fprintf(stream, "%s", (*iterator_member)->name);
     }
 }
\ No newline at end of file
@@ -1,439 +1,1861 @@
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
-#include "priority_queue.h"
+#include "priority_queue_internal.h"
 
-typedef struct ListNode
+#ifndef PQ_DEFAULT_BACKEND
+#define PQ_DEFAULT_BACKEND PQ_BACKEND_LIST
+#endif
+
+#define HASH_INITIAL_CAPACITY 16
+#define HASH_GROWTH_FACTOR 2
+#define NODE_CHUNK_MIN_CAPACITY 16
+#define NODE_CHUNK_MAX_CAPACITY 4096
+#define FRONTIER_INITIAL_CAPACITY 16
+#define FRONTIER_GROWTH_FACTOR 2
+
+//Context for looking up the node of an element among all the nodes of an engine
+typedef struct NodeSearch_t
 {
     PQElement element;
-    PQElementPriority element_priority;
-    struct ListNode* next;
-}*Node;
+    PQElementPriority priority; //NULL matches any priority
+    Node found;
+} NodeSearch;
 
-struct PriorityQueue_t
+//Context for collecting all the nodes of an engine into an array
+typedef struct NodeCollection_t
 {
-    int size;
-    Node list;
-    Node iterator_current_position;
+    Node* nodes;
+    int count;
+} NodeCollection;
 
-    CopyPQElement copyElementFunction;
-    FreePQElement freeElementFunction;
-    EqualPQElements isEqualElementFunction;
-    CopyPQElementPriority copyPriorityFunction;
-    FreePQElementPriority freeElementPriority; 
-    ComparePQElementPriorities comparePrioritiesFunction;
-};
+//Heap of the nodes that may come next while reading the first nodes of a tree shaped engine
+typedef struct NodeFrontier_t
+{
+    Node* nodes;
+    int count;
+    int capacity;
+    bool failed; //an allocation failed, some node was not added
+} NodeFrontier;
 
-static Node createNode(PQElement element, PQElementPriority element_priority);
+static const PQEngine* engineOf(PQBackend backend);
+static PriorityQueue createQueue(PQBackend backend, size_t element_size, size_t priority_size,
+                                 CopyPQElement copy_element, FreePQElement free_element,
+                                 EqualPQElements equal_elements, HashPQElement hash_element,
+                                 CopyPQElementPriority copy_priority, FreePQElementPriority free_priority,
+                                 ComparePQElementPriorities compare_priorities, PQPriorityKey priority_key);
+static int storageUnits(size_t size);
+static bool isInline(PriorityQueue queue);
+static bool addNodeChunk(PriorityQueue queue, int capacity);
+static void freeNodeChunks(PriorityQueue queue);
+static Node createNode(PriorityQueue queue, PQElement element, PQElementPriority element_priority);
+static void releaseNode(PriorityQueue queue, Node node);
 static void destroyNode(PriorityQueue queue, Node node);
+static void destroyNodeVisitor(PriorityQueue queue, Node node, void* context);
+static Node createNodeCopy(PriorityQueue queue, PQElement element, PQElementPriority priority);
+static Node createInlineNode(PriorityQueue queue, PQElement element, PQElementPriority priority);
+static PQElement duplicateBytes(const void* source, size_t size);
+static PriorityQueueResult popInlineNode(PriorityQueue queue, Node node, PQElement* element,
+                                         PQElementPriority* priority);
 static Node copyNode(PriorityQueue queue, Node old);
-static Node copyList(PriorityQueue queue);
-static void destroyList(PriorityQueue queue, Node node);
+static bool attachNode(PriorityQueue queue, Node node);
+static void detachNode(PriorityQueue queue, Node node);
+static void reinsertNode(PriorityQueue queue, Node node, PQElement element, PQElementPriority priority);
+static void invalidateIterator(PriorityQueue queue);
 static bool isNodeEqual(PriorityQueue queue, Node a, PQElement e, PQElementPriority p);
+static void searchNodeVisitor(PriorityQueue queue, Node node, void* context);
+static Node findNode(PriorityQueue queue, PQElement element, PQElementPriority priority);
+static void collectNodeVisitor(PriorityQueue queue, Node node, void* context);
+static bool buildSnapshot(PriorityQueue queue);
+static Node nodeSuccessor(PriorityQueue queue, Node node);
+static bool linkBatch(PriorityQueue queue, Node* nodes, int count);
+static int hashBucketOf(PriorityQueue queue, unsigned long hash);
+static void hashIndexAdd(PriorityQueue queue, Node node);
+static void hashIndexRemove(PriorityQueue queue, Node node);
+static void hashIndexGrow(PriorityQueue queue);
+static void hashIndexReset(PriorityQueue queue);
+static bool canMerge(PriorityQueue destination, PriorityQueue source);
+static int collectFirstNodes(PriorityQueue queue, Node* nodes, int count);
+static bool collectFirstNodesOfTree(PriorityQueue queue, Node* nodes, int count);
+static void frontierPushVisitor(PriorityQueue queue, Node node, void* context);
+static Node frontierPop(PriorityQueue queue, NodeFrontier* frontier);
+static void stampMergedNodeVisitor(PriorityQueue queue, Node node, void* context);
+static void moveNodePool(PriorityQueue destination, PriorityQueue source);
+static void lastNodeVisitor(PriorityQueue queue, Node node, void* context);
+static Node lastNode(PriorityQueue queue);
+static Node peekLastNode(PriorityQueue queue);
+static bool trimToBound(PriorityQueue queue, Node kept);
+static bool isBeyondBound(PriorityQueue queue, PQElementPriority priority);
+static int liveSize(PriorityQueue queue);
+static Node firstNode(PriorityQueue queue);
+static Node peekFirstNode(PriorityQueue queue);
+static void buryNode(PriorityQueue queue, Node node);
+static void purgeNode(PriorityQueue queue, Node node);
+static void collectRemovedNodeVisitor(PriorityQueue queue, Node node, void* context);
+static void compactQueue(PriorityQueue queue);
 
-//allocates a node that contains an element and a priority
-static Node createNode(PQElement element, PQElementPriority element_priority)
+//returns the engine implementing backend, NULL if there is no such backend
+static const PQEngine* engineOf(PQBackend backend)
 {
-    Node node = malloc(sizeof(*node));
-    if(node == NULL)
+    switch(backend)
     {
-        return NULL;
+        case PQ_BACKEND_LIST:
+            return &pqListEngine;
+        case PQ_BACKEND_BINARY_HEAP:
+            return &pqBinaryHeapEngine;
+        case PQ_BACKEND_PAIRING_HEAP:
+            return &pqPairingHeapEngine;
+        case PQ_BACKEND_MIN_MAX_HEAP:
+            return &pqMinMaxHeapEngine;
+        case PQ_BACKEND_SKIPLIST:
+            return &pqSkiplistEngine;
+        case PQ_BACKEND_4_ARY_HEAP:
+            return &pqFourAryHeapEngine;
+        case PQ_BACKEND_8_ARY_HEAP:
+            return &pqEightAryHeapEngine;
+        case PQ_BACKEND_RADIX_HEAP:
+            return &pqRadixHeapEngine;
+        case PQ_BACKEND_CALENDAR_QUEUE:
+            return &pqCalendarQueueEngine;
+        default:
+            return NULL;
+    }
+}
+
+//returns how many storage units size bytes take
+static int storageUnits(size_t size)
+{
+    return (int) ((size + sizeof(NodeStorage) - 1) / sizeof(NodeStorage));
+}
+
+static bool isInline(PriorityQueue queue)
+{
+    return queue->element_size > 0;
+}
+
+//allocates a chunk of capacity nodes and puts all of them on the free list
+static bool addNodeChunk(PriorityQueue queue, int capacity)
+{
+    NodeChunk chunk = malloc(sizeof(*chunk) + sizeof(chunk->storage[0]) * queue->node_units * capacity);
+    if(chunk == NULL)
+    {
+        return false;
+    }
+    chunk->capacity = capacity;
+    chunk->next = queue->node_chunks;
+    queue->node_chunks = chunk;
+    for(int i = capacity - 1; i >= 0; i--)
+    {
+        Node node = (Node) &chunk->storage[i * queue->node_units];
+        node->next = queue->free_nodes;
+        queue->free_nodes = node;
+    }
+    queue->free_node_count += capacity;
+    queue->node_capacity += capacity;
+    return true;
+}
+
+//frees every chunk of the queue, the nodes in them must not be in use
+static void freeNodeChunks(PriorityQueue queue)
+{
+    while(queue->node_chunks)
+    {
+        NodeChunk next = queue->node_chunks->next;
+        free(queue->node_chunks);
+        queue->node_chunks = next;
     }
+    queue->free_nodes = NULL;
+    queue->free_node_count = 0;
+    queue->node_capacity = 0;
+}
+
+//takes a node off the free list, growing the pool by a chunk as large as the pool if it is empty,
+//and fills it with an element and a priority
+static Node createNode(PriorityQueue queue, PQElement element, PQElementPriority element_priority)
+{
+    if(queue->free_nodes == NULL)
+    {
+        int capacity = queue->node_capacity;
+        capacity = capacity < NODE_CHUNK_MIN_CAPACITY ? NODE_CHUNK_MIN_CAPACITY : capacity;
+        capacity = capacity > NODE_CHUNK_MAX_CAPACITY ? NODE_CHUNK_MAX_CAPACITY : capacity;
+        if(!addNodeChunk(queue, capacity))
+        {
+            return NULL;
+        }
+    }
+    Node node = queue->free_nodes;
+    queue->free_nodes = node->next;
+    queue->free_node_count--;
     node->element = element;
     node->element_priority = element_priority;
+    node->sequence = 0;
     node->next = NULL;
+    node->prev = NULL;
+    node->child = NULL;
+    node->parent = NULL;
+    node->index = -1;
+    node->rank = -1;
+    node->hash = 0;
+    node->hash_next = NULL;
+    node->forward = NULL;
+    node->removed = false;
     return node;
 }
 
-//frees given node using functions given by user
+//returns an unused node to the free list
+static void releaseNode(PriorityQueue queue, Node node)
+{
+    node->next = queue->free_nodes;
+    queue->free_nodes = node;
+    queue->free_node_count++;
+}
+
+//frees given node's contents using functions given by user and releases the node
 static void destroyNode(PriorityQueue queue, Node node)
 {
-    node->next = NULL;
-    queue->freeElementFunction(node->element);
-    queue->freeElementPriority(node->element_priority);
-    free(node);
+    if(!isInline(queue))
+    {
+        if(!node->removed)
+        {
+            queue->freeElementFunction(node->element); //a lazy removal has freed it already
+        }
+        queue->freeElementPriority(node->element_priority);
+    }
+    releaseNode(queue, node);
 }
 
-//copies given node using functions given by user
-static Node copyNode(PriorityQueue queue, Node old)
+static void destroyNodeVisitor(PriorityQueue queue, Node node, void* context)
 {
-    Node new_node = malloc(sizeof(*new_node));
-    if(new_node == NULL)
+    destroyNode(queue, node);
+}
+
+//allocates a node that contains copies of element and priority made by the functions given by user
+static Node createNodeCopy(PriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+    if(isInline(queue))
+    {
+        return createInlineNode(queue, element, priority);
+    }
+    PQElement element_copy = queue->copyElementFunction(element);
+    if(element_copy == NULL)
     {
         return NULL;
     }
-    new_node->element = queue->copyElementFunction(old->element);
-    if(new_node->element == NULL)
+    PQElementPriority priority_copy = queue->copyPriorityFunction(priority);
+    if(priority_copy == NULL)
     {
-        free(new_node);
+        queue->freeElementFunction(element_copy);
         return NULL;
     }
-    new_node->element_priority = queue->copyPriorityFunction(old->element_priority);
-    if(new_node->element_priority == NULL)
+    Node new_node = createNode(queue, element_copy, priority_copy);
+    if(new_node == NULL)
     {
-        queue->freeElementFunction(new_node->element);
-        free(new_node);
+        queue->freeElementFunction(element_copy);
+        queue->freeElementPriority(priority_copy);
         return NULL;
     }
-    new_node->next = NULL;
     return new_node;
 }
 
-//returns a pointer to a copy of queue->list
-static Node copyList(PriorityQueue queue)
+//allocates a node of an inline queue and copies element and priority into its own storage
+static Node createInlineNode(PriorityQueue queue, PQElement element, PQElementPriority priority)
 {
-    if(queue == NULL || queue->list == NULL)
+    NodeStorage* storage = (NodeStorage*) createNode(queue, NULL, NULL);
+    if(storage == NULL)
     {
         return NULL;
     }
-    Node new_list = copyNode(queue, queue->list);
-    if(new_list == NULL)
+    Node node = (Node) storage;
+    storage += storageUnits(sizeof(struct PQNode_t));
+    node->element = memcpy(storage, element, queue->element_size);
+    storage += storageUnits(queue->element_size);
+    node->element_priority = memcpy(storage, priority, queue->priority_size);
+    return node;
+}
+
+//returns a malloc'd copy of size bytes, NULL if the allocation failed
+static PQElement duplicateBytes(const void* source, size_t size)
+{
+    void* copy = malloc(size);
+    return copy == NULL ? NULL : memcpy(copy, source, size);
+}
+
+//copies a node of an inline queue out to malloc'd blocks for the caller and removes it,
+//pqPopFirst for inline queues. A NULL output receives nothing
+static PriorityQueueResult popInlineNode(PriorityQueue queue, Node node, PQElement* element,
+                                         PQElementPriority* priority)
+{
+    PQElement element_copy = NULL;
+    PQElementPriority priority_copy = NULL;
+    if(element != NULL && (element_copy = duplicateBytes(node->element, queue->element_size)) == NULL)
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(priority != NULL && (priority_copy = duplicateBytes(node->element_priority, queue->priority_size)) == NULL)
+    {
+        free(element_copy);
+        return PQ_OUT_OF_MEMORY;
+    }
+    detachNode(queue, node);
+    releaseNode(queue, node);
+    if(element != NULL)
+    {
+        *element = element_copy;
+    }
+    if(priority != NULL)
     {
-        return NULL;// malloc failed in copyNode()
+        *priority = priority_copy;
     }
+    return PQ_SUCCESS;
+}
 
-    Node tmp = new_list;
-    Node current = queue->list->next;  
-    while(current)
+//copies given node into queue. The copy keeps the insertion stamp
+static Node copyNode(PriorityQueue queue, Node old)
+{
+    Node new_node = createNodeCopy(queue, old->element, old->element_priority);
+    if(new_node != NULL)
     {
-        assert(current != NULL);
-        tmp->next = copyNode(queue, current);
-        tmp = tmp->next;
-        if(tmp == NULL)
-        {
-            destroyList(queue, new_list);
-            return NULL;// malloc failed in copyNode()
-        }
-        current = current->next;
+        new_node->sequence = old->sequence;
     }
-    return new_list;
+    return new_node;
 }
 
-PriorityQueue pqCreate(CopyPQElement copy_element,
-					   FreePQElement free_element,
-					   EqualPQElements equal_elements,
-                       CopyPQElementPriority copy_priority,
-                       FreePQElementPriority free_priority,
-                       ComparePQElementPriorities compare_priorities)
+//stamps node as the most recently inserted and links it into the engine
+static bool attachNode(PriorityQueue queue, Node node)
 {
-    PriorityQueue queue = (PriorityQueue) malloc(sizeof(*queue));
-    if(queue == NULL)
+    invalidateIterator(queue);
+    node->sequence = queue->next_sequence;
+    if(!queue->engine->insert(queue, node))
     {
-        return NULL;
+        return false;
     }
-    queue->list = NULL;
-    queue->size = 0;
-    queue->iterator_current_position = NULL;
-    queue->copyElementFunction = copy_element;
-    queue->freeElementFunction = free_element;
-    queue->isEqualElementFunction = equal_elements;
-    queue->copyPriorityFunction = copy_priority;
-    queue->freeElementPriority = free_priority;
-    queue->comparePrioritiesFunction = compare_priorities;
-    return queue;
+    queue->next_sequence++;
+    queue->size++;
+    hashIndexAdd(queue, node);
+    return true;
+}
+
+//unlinks node from the engine without freeing it
+static void detachNode(PriorityQueue queue, Node node)
+{
+    invalidateIterator(queue);
+    queue->engine->detach(queue, node);
+    queue->size--;
+    hashIndexRemove(queue, node);
 }
 
-//frees the whole node tree
-static void destroyList(PriorityQueue queue, Node node)
+//replaces the contents of a linked node and reinserts it as the most recently inserted node.
+//The old contents are freed. A NULL element keeps the current element.
+//Inline queues copy element and priority over the old contents instead, they may overlap them
+static void reinsertNode(PriorityQueue queue, Node node, PQElement element, PQElementPriority priority)
 {
-    Node current = node;
-    Node tmp;
-    while(current)//NULL safe
+    detachNode(queue, node);
+    if(isInline(queue))
+    {
+        if(element != NULL)
+        {
+            memmove(node->element, element, queue->element_size);
+        }
+        memmove(node->element_priority, priority, queue->priority_size);
+    }
+    else
     {
-        tmp = current;
-        current = current->next;
-        destroyNode(queue, tmp);
+        if(element != NULL)
+        {
+            queue->freeElementFunction(node->element);
+            node->element = element;
+        }
+        queue->freeElementPriority(node->element_priority);
+        node->element_priority = priority;
     }
+    //no engine allocates to link a node that was just detached from it, the heaps still have its slot
+    bool attached = attachNode(queue, node);
+    assert(attached);
+    (void) attached;
 }
 
-void pqDestroy(PriorityQueue queue)
+static void invalidateIterator(PriorityQueue queue)
 {
-    if(!queue)
+    queue->iterator_current_position = NULL;
+    queue->snapshot_valid = false;
+}
+
+//compares a node to an element and a priority
+static bool isNodeEqual(PriorityQueue queue, Node a, PQElement e, PQElementPriority p)
+{
+    if(!a || !e || !queue || a->removed)
     {
-        return;
+        return false;
+    }
+    if(p != NULL && queue->comparePrioritiesFunction(a->element_priority, p) != 0)
+    {
+        return false;
     }
-    destroyList(queue, queue->list);
-    free(queue);   
+    return queue->isEqualElementFunction(a->element, e);
 }
 
-PriorityQueue pqCopy(PriorityQueue queue)
+static void searchNodeVisitor(PriorityQueue queue, Node node, void* context)
 {
-    if(queue == NULL)
+    NodeSearch* search = context;
+    if(search->found != NULL && !pqNodeBefore(queue, node, search->found))
     {
-        return NULL;
+        return;
     }
-    PriorityQueue new_queue = pqCreate(queue->copyElementFunction,
-            queue->freeElementFunction,
-            queue->isEqualElementFunction,
-            queue->copyPriorityFunction,
-            queue->freeElementPriority,
-            queue->comparePrioritiesFunction);
-    if(new_queue == NULL)
+    if(isNodeEqual(queue, node, search->element, search->priority))
     {
-        return NULL;
+        search->found = node;
     }
-    queue->iterator_current_position = NULL;
-    if(queue->list != NULL)
+}
+
+//returns the first node in the queue's order that holds element (and priority, unless it is NULL)
+static Node findNode(PriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+    if(queue->hash_buckets != NULL)
     {
-        new_queue->list = copyList(queue);
-        if(new_queue->list == NULL)
+        //only the equal elements share the bucket, keep the first of them in order
+        NodeSearch search = {element, priority, NULL};
+        unsigned long hash = queue->hashElementFunction(element);
+        for(Node current = queue->hash_buckets[hashBucketOf(queue, hash)]; current; current = current->hash_next)
         {
-            pqDestroy(new_queue);
-            return NULL; //malloc fail in copyNode()
+            if(current->hash == hash)
+            {
+                searchNodeVisitor(queue, current, &search);
+            }
         }
+        return search.found;
     }
-    else
+    if(queue->engine->successor != NULL)
     {
-        new_queue->list = NULL;
+        Node current = queue->engine->first(queue);
+        while(current && !isNodeEqual(queue, current, element, priority))
+        {
+            current = queue->engine->successor(queue, current);
+        }
+        return current;
     }
-    new_queue->size = queue->size;
-    new_queue->iterator_current_position = NULL;
-    return new_queue;
+    NodeSearch search = {element, priority, NULL};
+    queue->engine->visitAll(queue, searchNodeVisitor, &search);
+    return search.found;
 }
 
-PriorityQueueResult pqClear(PriorityQueue queue)
+static void collectNodeVisitor(PriorityQueue queue, Node node, void* context)
 {
-    if(queue == NULL)
-    {
-        return PQ_NULL_ARGUMENT;
-    }
-    destroyList(queue, queue->list);
-    queue->list = NULL;
-    queue->size = 0;
-    queue->iterator_current_position = NULL;
-    return PQ_SUCCESS; 
+    NodeCollection* collection = context;
+    collection->nodes[collection->count++] = node;
 }
 
-int pqGetSize(PriorityQueue queue)
+void pqSortNodes(PriorityQueue queue, Node* nodes, Node* buffer, int count)
 {
-    if (!queue)
+    for(int width = 1; width < count; width *= 2)
     {
-        return -1;
+        for(int start = 0; start < count; start += 2 * width)
+        {
+            int middle = start + width < count ? start + width : count;
+            int end = start + 2 * width < count ? start + 2 * width : count;
+            int left = start, right = middle, out = start;
+            while(left < middle && right < end)
+            {
+                buffer[out++] = pqNodeBefore(queue, nodes[right], nodes[left]) ? nodes[right++] : nodes[left++];
+            }
+            while(left < middle)
+            {
+                buffer[out++] = nodes[left++];
+            }
+            while(right < end)
+            {
+                buffer[out++] = nodes[right++];
+            }
+        }
+        for(int i = 0; i < count; i++)
+        {
+            nodes[i] = buffer[i];
+        }
     }
-    return queue->size;
 }
 
-PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPriority priority)
+//sorts all the nodes into queue->ordered_snapshot and records every node's rank in it
+static bool buildSnapshot(PriorityQueue queue)
 {
-    if(queue == NULL || element == NULL || priority == NULL)
+    if(queue->snapshot_capacity < queue->size)
     {
-        return PQ_NULL_ARGUMENT;
+        Node* new_snapshot = realloc(queue->ordered_snapshot, sizeof(*new_snapshot) * queue->size);
+        if(new_snapshot == NULL)
+        {
+            return false;
+        }
+        queue->ordered_snapshot = new_snapshot;
+        queue->snapshot_capacity = queue->size;
     }
-    queue->iterator_current_position = NULL;
-    PQElement element_copy = queue->copyElementFunction(element);
-    if (element_copy == NULL)
+    Node* buffer = malloc(sizeof(*buffer) * (queue->size > 0 ? queue->size : 1));
+    if(buffer == NULL)
     {
-        return PQ_OUT_OF_MEMORY;
+        return false;
     }
-    PQElementPriority element_priority_copy = queue->copyPriorityFunction(priority);
-    if (!element_priority_copy)
+    NodeCollection collection = {queue->ordered_snapshot, 0};
+    queue->engine->visitAll(queue, collectNodeVisitor, &collection);
+    assert(collection.count == queue->size);
+    pqSortNodes(queue, queue->ordered_snapshot, buffer, queue->size);
+    free(buffer);
+    for(int i = 0; i < queue->size; i++)
     {
-        queue->freeElementFunction(element_copy);
-        return PQ_OUT_OF_MEMORY;
+        queue->ordered_snapshot[i]->rank = i;
     }
-    Node node = createNode(element_copy, element_priority_copy);
-    if (!node)
+    queue->snapshot_count = queue->size;
+    queue->snapshot_valid = true;
+    return true;
+}
+
+//returns the node following node in priority order, NULL at the end or if sorting failed.
+//Lazily removed nodes are skipped
+static Node nodeSuccessor(PriorityQueue queue, Node node)
+{
+    if(queue->engine->successor != NULL)
     {
-        queue->freeElementFunction(element_copy);
-        queue->freeElementPriority(element_priority_copy);
-        return PQ_OUT_OF_MEMORY;
+        do
+        {
+            node = queue->engine->successor(queue, node);
+        } while(node != NULL && node->removed);
+        return node;
     }
-    Node current = queue->list;
-    if (!current) //the list is empty
+    if(!queue->snapshot_valid && !buildSnapshot(queue))
     {
-        queue->list = node;
-        queue->size++;
-        return PQ_SUCCESS;
-    } 
-    if(queue->comparePrioritiesFunction(node->element_priority,current->element_priority) > 0)
-    {
-        node->next = current;
-        queue->list = node;
-        queue->size++;
-        return PQ_SUCCESS;
+        return NULL;
     }
-    while(current->next != NULL && 
-    queue->comparePrioritiesFunction(node->element_priority,current->next->element_priority) <= 0)
+    for(int rank = node->rank + 1; rank < queue->snapshot_count; rank++)
     {
-        current = current->next;
+        Node following = queue->ordered_snapshot[rank];
+        if(following != NULL && !following->removed)
+        {
+            return following;
+        }
     }
-    node->next = current->next;  
-    current->next = node;
-    assert(node->next != current->next);
-    queue->size++;
-    return PQ_SUCCESS;
+    return NULL;
 }
-    
-bool pqContains(PriorityQueue queue, PQElement element)
+
+//returns the bucket of a hash, the capacity is a power of two
+static int hashBucketOf(PriorityQueue queue, unsigned long hash)
 {
-    if(!queue || !element)
+    hash ^= hash >> 16;
+    return (int) (hash & (unsigned long) (queue->hash_capacity - 1));
+}
+
+//adds a linked node to the hash index, if the queue keeps one
+static void hashIndexAdd(PriorityQueue queue, Node node)
+{
+    if(queue->hash_buckets == NULL)
     {
-        return false;
+        return;
     }
-    
-    Node current = queue->list;
-    while(current)
+    if(queue->size > queue->hash_capacity)
     {
-        if(queue->isEqualElementFunction(current->element, element))
-        {
-            return true;
-        }
-        current = current->next;
+        hashIndexGrow(queue);
     }
-    return false;
+    node->hash = queue->hashElementFunction(node->element);
+    int bucket = hashBucketOf(queue, node->hash);
+    node->hash_next = queue->hash_buckets[bucket];
+    queue->hash_buckets[bucket] = node;
 }
 
-PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element)
+//removes a node from the hash index, if the queue keeps one
+static void hashIndexRemove(PriorityQueue queue, Node node)
 {
-    if(!queue || !element)
+    if(queue->hash_buckets == NULL)
     {
-        return PQ_NULL_ARGUMENT;
+        return;
     }
-    queue->iterator_current_position = NULL;
-    Node first = queue->list;
-    
-    if(!first)
+    Node* link = &queue->hash_buckets[hashBucketOf(queue, node->hash)];
+    while(*link != node)
     {
-        return PQ_ELEMENT_DOES_NOT_EXISTS;
+        assert(*link != NULL);
+        link = &(*link)->hash_next;
     }
+    *link = node->hash_next;
+    node->hash_next = NULL;
+}
 
-    //The case in which the first element is the element to remove is addressed differently
-    if(queue->isEqualElementFunction(element, first->element))
+//doubles the number of buckets. If the allocation fails the index keeps working with longer chains
+static void hashIndexGrow(PriorityQueue queue)
+{
+    int new_capacity = queue->hash_capacity * HASH_GROWTH_FACTOR;
+    Node* new_buckets = malloc(sizeof(*new_buckets) * new_capacity);
+    if(new_buckets == NULL)
     {
-        queue->list = first->next;
-        destroyNode(queue, first);
-        queue->size--;
-        return PQ_SUCCESS;
+        return;
     }
-
-    Node current = first;
-    Node next = current->next;
-    while(next)
+    for(int i = 0; i < new_capacity; i++)
     {
-        if(queue->isEqualElementFunction(next->element, element))
+        new_buckets[i] = NULL;
+    }
+    Node* old_buckets = queue->hash_buckets;
+    int old_capacity = queue->hash_capacity;
+    queue->hash_buckets = new_buckets;
+    queue->hash_capacity = new_capacity;
+    for(int i = 0; i < old_capacity; i++)
+    {
+        Node current = old_buckets[i];
+        while(current)
         {
-            current->next = next->next;
-            destroyNode(queue, next);
-            queue->size--;
-            return PQ_SUCCESS;
+            Node next = current->hash_next;
+            int bucket = hashBucketOf(queue, current->hash);
+            current->hash_next = new_buckets[bucket];
+            new_buckets[bucket] = current;
+            current = next;
         }
-        current = next;
-        next = next->next;
     }
-    return PQ_ELEMENT_DOES_NOT_EXISTS; 
+    free(old_buckets);
 }
 
-//compares two nodes
-static bool isNodeEqual(PriorityQueue queue, Node a, PQElement e, PQElementPriority p)
+static void hashIndexReset(PriorityQueue queue)
 {
-    if(!a || !p || !e || !queue)
+    for(int i = 0; queue->hash_buckets != NULL && i < queue->hash_capacity; i++)
     {
-        return false;
+        queue->hash_buckets[i] = NULL;
     }
-    bool prioritySame = queue->comparePrioritiesFunction(a->element_priority, p) == 0;
-    bool elementSame = queue->isEqualElementFunction(a->element, e);
-    return prioritySame && elementSame;
 }
 
-PriorityQueueResult pqChangePriority(PriorityQueue     queue, 
-									 PQElement     	   element,
-                                     PQElementPriority old_priority, 
-									 PQElementPriority new_priority)
+//links stamped nodes into the engine, all of them or none
+static bool linkBatch(PriorityQueue queue, Node* nodes, int count)
 {
-    if(!queue || !element || !old_priority || !old_priority)
+    if(queue->engine->build != NULL)
     {
-        return PQ_NULL_ARGUMENT;
+        return queue->engine->build(queue, nodes, count);
     }
-    queue->iterator_current_position = NULL;
-    Node first = queue->list;
-    if(!first)
+    for(int i = 0; i < count; i++)
     {
-        return PQ_ELEMENT_DOES_NOT_EXISTS;
-    }
-    if(isNodeEqual(queue, first, element, old_priority))
-	{   
-		queue->list = first->next;
-		PriorityQueueResult pq_result = pqInsert(queue, element, new_priority);
-		if(pq_result != PQ_SUCCESS)
-		{
-			queue->list = first;//reversing changes
-			return pq_result;
-		}
-		else
-		{
-			destroyNode(queue, first);
-			queue->size--;
-			return pq_result;
-		}
-	}
-    Node current = queue->list;
-    Node next = current->next;	
-    while (next)
-    {
-        if(isNodeEqual(queue, next, element, old_priority))
-        {
-            current->next = next->next;	
-            PriorityQueueResult pq_result = pqInsert(queue, element, new_priority);
-            if(pq_result != PQ_SUCCESS)
-            {
-                current->next = next;//reversing changes
-                return pq_result;
-            }
-            else
+        if(!queue->engine->insert(queue, nodes[i]))
+        {
+            //take back the ones that made it in, so nothing is left half inserted
+            for(int j = 0; j < i; j++)
             {
-                destroyNode(queue, next);
-                queue->size--;
-                return pq_result;
+                queue->engine->detach(queue, nodes[j]);
             }
+            return false;
         }
-        current = next; 
-        next = next->next;
     }
-    return PQ_ELEMENT_DOES_NOT_EXISTS;
+    return true;
 }
 
-PriorityQueueResult pqRemove(PriorityQueue queue)
+PriorityQueue pqCreate(CopyPQElement copy_element,
+					   FreePQElement free_element,
+					   EqualPQElements equal_elements,
+                       CopyPQElementPriority copy_priority,
+                       FreePQElementPriority free_priority,
+                       ComparePQElementPriorities compare_priorities)
 {
-    if (!queue)
-    {
-        return PQ_NULL_ARGUMENT;
-    }
-    queue->iterator_current_position = NULL;
-    if(queue->list == NULL)
-    {
-        assert(queue->size == 0);
-        return PQ_SUCCESS;
-    }
-    Node tmp = queue->list;
-    queue->list = queue->list->next;
-    destroyNode(queue, tmp);
-    queue->size--;
-    return PQ_SUCCESS;
+    return pqCreateWithBackend(PQ_DEFAULT_BACKEND, copy_element, free_element, equal_elements,
+                               copy_priority, free_priority, compare_priorities);
 }
 
-PQElement pqGetFirst(PriorityQueue queue)
+PriorityQueue pqCreateWithBackend(PQBackend backend,
+                                  CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  EqualPQElements equal_elements,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities)
 {
-    if(queue == NULL || queue->size == 0)
+    return pqCreateHashed(backend, copy_element, free_element, equal_elements, NULL,
+                          copy_priority, free_priority, compare_priorities);
+}
+
+PriorityQueue pqCreateHashed(PQBackend backend,
+                             CopyPQElement copy_element,
+                             FreePQElement free_element,
+                             EqualPQElements equal_elements,
+                             HashPQElement hash_element,
+                             CopyPQElementPriority copy_priority,
+                             FreePQElementPriority free_priority,
+                             ComparePQElementPriorities compare_priorities)
+{
+    return createQueue(backend, 0, 0, copy_element, free_element, equal_elements, hash_element,
+                       copy_priority, free_priority, compare_priorities, NULL);
+}
+
+PriorityQueue pqCreateKeyed(PQBackend backend,
+                            CopyPQElement copy_element,
+                            FreePQElement free_element,
+                            EqualPQElements equal_elements,
+                            HashPQElement hash_element,
+                            CopyPQElementPriority copy_priority,
+                            FreePQElementPriority free_priority,
+                            ComparePQElementPriorities compare_priorities,
+                            PQPriorityKey priority_key)
+{
+    if(priority_key == NULL)
     {
         return NULL;
     }
-    queue->iterator_current_position = queue->list;
-    return queue->iterator_current_position->element;
+    return createQueue(backend, 0, 0, copy_element, free_element, equal_elements, hash_element,
+                       copy_priority, free_priority, compare_priorities, priority_key);
 }
 
-PQElement pqGetNext(PriorityQueue queue)
+PriorityQueue pqCreateInline(size_t element_size,
+                             size_t priority_size,
+                             PQBackend backend,
+                             EqualPQElements equal_elements,
+                             HashPQElement hash_element,
+                             ComparePQElementPriorities compare_priorities)
 {
-    if(queue == NULL || queue->size == 0)
+    if(element_size == 0 || priority_size == 0)
     {
         return NULL;
     }
-    if(queue->iterator_current_position == NULL)
+    return createQueue(backend, element_size, priority_size, NULL, NULL, equal_elements, hash_element,
+                       NULL, NULL, compare_priorities, NULL);
+}
+
+PriorityQueue pqCreateBounded(int capacity,
+                              PQBackend backend,
+                              CopyPQElement copy_element,
+                              FreePQElement free_element,
+                              EqualPQElements equal_elements,
+                              CopyPQElementPriority copy_priority,
+                              FreePQElementPriority free_priority,
+                              ComparePQElementPriorities compare_priorities)
+{
+    if(capacity <= 0)
     {
         return NULL;
     }
-    queue->iterator_current_position = queue->iterator_current_position->next;
-    if(queue->iterator_current_position == NULL)
+    PriorityQueue queue = createQueue(backend, 0, 0, copy_element, free_element, equal_elements, NULL,
+                                      copy_priority, free_priority, compare_priorities, NULL);
+    if(queue != NULL)
     {
-        return NULL;
+        queue->bound = capacity;
+    }
+    return queue;
+}
+
+//allocates a new empty queue, an inline one if the sizes are not 0
+static PriorityQueue createQueue(PQBackend backend, size_t element_size, size_t priority_size,
+                                 CopyPQElement copy_element, FreePQElement free_element,
+                                 EqualPQElements equal_elements, HashPQElement hash_element,
+                                 CopyPQElementPriority copy_priority, FreePQElementPriority free_priority,
+                                 ComparePQElementPriorities compare_priorities, PQPriorityKey priority_key)
+{
+    const PQEngine* engine = engineOf(backend);
+    if(engine == NULL)
+    {
+        return NULL;
+    }
+    PriorityQueue queue = (PriorityQueue) malloc(sizeof(*queue));
+    if(queue == NULL)
+    {
+        return NULL;
+    }
+    queue->size = 0;
+    queue->backend = backend;
+    queue->engine = engine;
+    queue->engine_state = NULL;
+    queue->next_sequence = 0;
+    queue->bound = 0;
+    queue->removed_count = 0;
+    queue->removed_fraction = 0;
+    queue->iterator_current_position = NULL;
+    queue->ordered_snapshot = NULL;
+    queue->snapshot_count = 0;
+    queue->snapshot_capacity = 0;
+    queue->snapshot_valid = false;
+    queue->copyElementFunction = copy_element;
+    queue->freeElementFunction = free_element;
+    queue->isEqualElementFunction = equal_elements;
+    queue->copyPriorityFunction = copy_priority;
+    queue->freeElementPriority = free_priority;
+    queue->comparePrioritiesFunction = compare_priorities;
+    queue->hashElementFunction = hash_element;
+    queue->priorityKeyFunction = priority_key;
+    queue->node_chunks = NULL;
+    queue->free_nodes = NULL;
+    queue->free_node_count = 0;
+    queue->node_capacity = 0;
+    queue->element_size = element_size;
+    queue->priority_size = priority_size;
+    queue->node_units = storageUnits(sizeof(struct PQNode_t)) + storageUnits(element_size) +
+                        storageUnits(priority_size);
+    queue->hash_buckets = NULL;
+    queue->hash_capacity = 0;
+    if(hash_element != NULL)
+    {
+        queue->hash_buckets = malloc(sizeof(*queue->hash_buckets) * HASH_INITIAL_CAPACITY);
+        if(queue->hash_buckets == NULL)
+        {
+            free(queue);
+            return NULL;
+        }
+        queue->hash_capacity = HASH_INITIAL_CAPACITY;
+        hashIndexReset(queue);
+    }
+    if(!engine->init(queue))
+    {
+        free(queue->hash_buckets);
+        free(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+void pqDestroy(PriorityQueue queue)
+{
+    if(!queue)
+    {
+        return;
+    }
+    pqClear(queue);
+    queue->engine->release(queue);
+    free(queue->ordered_snapshot);
+    free(queue->hash_buckets);
+    freeNodeChunks(queue);
+    free(queue);
+}
+
+PriorityQueue pqCopy(PriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return NULL;
+    }
+    PriorityQueue new_queue = createQueue(queue->backend,
+            queue->element_size,
+            queue->priority_size,
+            queue->copyElementFunction,
+            queue->freeElementFunction,
+            queue->isEqualElementFunction,
+            queue->hashElementFunction,
+            queue->copyPriorityFunction,
+            queue->freeElementPriority,
+            queue->comparePrioritiesFunction,
+            queue->priorityKeyFunction);
+    if(new_queue == NULL)
+    {
+        return NULL;
+    }
+    queue->iterator_current_position = NULL;
+    new_queue->next_sequence = queue->next_sequence;
+    new_queue->bound = queue->bound;
+    new_queue->removed_fraction = queue->removed_fraction;
+    if(pqReserve(new_queue, liveSize(queue)) != PQ_SUCCESS)
+    {
+        pqDestroy(new_queue);
+        return NULL;
+    }
+    //the nodes are copied in order, so every copy goes after the ones copied before it
+    Node current = firstNode(queue);
+    while(current)
+    {
+        Node copy = copyNode(new_queue, current);
+        if(copy == NULL || !new_queue->engine->append(new_queue, copy))
+        {
+            if(copy != NULL)
+            {
+                destroyNode(new_queue, copy);
+            }
+            pqDestroy(new_queue);
+            return NULL; //malloc fail in copyNode()
+        }
+        new_queue->size++;
+        hashIndexAdd(new_queue, copy);
+        current = nodeSuccessor(queue, current);
+    }
+    if(new_queue->size != liveSize(queue))
+    {
+        pqDestroy(new_queue);
+        return NULL; //sorting the source failed midway
+    }
+    queue->iterator_current_position = NULL;
+    return new_queue;
+}
+
+PriorityQueueResult pqClear(PriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->engine->visitAll(queue, destroyNodeVisitor, NULL);
+    queue->engine->reset(queue);
+    hashIndexReset(queue);
+    queue->size = 0;
+    queue->removed_count = 0;
+    invalidateIterator(queue);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqReserve(PriorityQueue queue, int capacity)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    int missing = capacity - queue->size - queue->free_node_count;
+    if(missing > 0 && !addNodeChunk(queue, missing))
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(queue->engine->reserve != NULL && !queue->engine->reserve(queue, capacity))
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    while(queue->hash_buckets != NULL && queue->hash_capacity < capacity)
+    {
+        int old_capacity = queue->hash_capacity;
+        hashIndexGrow(queue);
+        if(queue->hash_capacity == old_capacity)
+        {
+            return PQ_OUT_OF_MEMORY;
+        }
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqSetLazyRemoval(PriorityQueue queue, double max_removed_fraction)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(max_removed_fraction < 0 || max_removed_fraction > 1)
+    {
+        return PQ_ERROR;
+    }
+    queue->removed_fraction = max_removed_fraction;
+    if(queue->removed_count > max_removed_fraction * queue->size)
+    {
+        compactQueue(queue);
+    }
+    return PQ_SUCCESS;
+}
+
+int pqGetSize(PriorityQueue queue)
+{
+    if (!queue)
+    {
+        return -1;
+    }
+    return liveSize(queue);
+}
+
+PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+    return pqInsertWithHandle(queue, element, priority, NULL);
+}
+
+PriorityQueueResult pqInsertWithHandle(PriorityQueue queue, PQElement element, PQElementPriority priority,
+                                       PQHandle* handle)
+{
+    if(queue == NULL || element == NULL || priority == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    if(isBeyondBound(queue, priority))
+    {
+        //the new element would be dropped right away, so it is not copied at all
+        if(handle != NULL)
+        {
+            *handle = NULL;
+        }
+        return PQ_SUCCESS;
+    }
+    Node node = createNodeCopy(queue, element, priority);
+    if (!node)
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(!attachNode(queue, node))
+    {
+        destroyNode(queue, node);
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(handle != NULL)
+    {
+        *handle = trimToBound(queue, node) ? node : NULL;
+    }
+    else
+    {
+        trimToBound(queue, node);
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqInsertNoCopy(PriorityQueue queue, PQElement element, PQElementPriority priority,
+                                   PQHandle* handle)
+{
+    if(queue == NULL || element == NULL || priority == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    Node node = isInline(queue) ? createInlineNode(queue, element, priority) : createNode(queue, element, priority);
+    if(node == NULL)
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(!attachNode(queue, node))
+    {
+        releaseNode(queue, node);
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(isInline(queue))
+    {
+        //the node holds its own copy, what was handed over is not needed anymore
+        free(element);
+        free(priority);
+    }
+    bool kept = trimToBound(queue, node);
+    if(handle != NULL)
+    {
+        *handle = kept ? node : NULL;
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqInsertBatch(PriorityQueue queue, PQElement* elements, PQElementPriority* priorities,
+                                  int count)
+{
+    if(queue == NULL || elements == NULL || priorities == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(count < 0)
+    {
+        return PQ_ERROR;
+    }
+    for(int i = 0; i < count; i++)
+    {
+        if(elements[i] == NULL || priorities[i] == NULL)
+        {
+            return PQ_NULL_ARGUMENT;
+        }
+    }
+    if(count == 0)
+    {
+        return PQ_SUCCESS;
+    }
+    queue->iterator_current_position = NULL;
+    Node* nodes = malloc(sizeof(*nodes) * count);
+    if(nodes == NULL || pqReserve(queue, queue->size + count) != PQ_SUCCESS)
+    {
+        free(nodes);
+        return PQ_OUT_OF_MEMORY;
+    }
+    int created = 0;
+    while(created < count)
+    {
+        Node node = createNodeCopy(queue, elements[created], priorities[created]);
+        if(node == NULL)
+        {
+            break;
+        }
+        node->sequence = queue->next_sequence + created;
+        nodes[created++] = node;
+    }
+    if(created < count || !linkBatch(queue, nodes, count))
+    {
+        for(int i = 0; i < created; i++)
+        {
+            destroyNode(queue, nodes[i]);
+        }
+        free(nodes);
+        return PQ_OUT_OF_MEMORY;
+    }
+    invalidateIterator(queue);
+    queue->next_sequence += count;
+    for(int i = 0; i < count; i++)
+    {
+        queue->size++;
+        hashIndexAdd(queue, nodes[i]);
+    }
+    free(nodes);
+    trimToBound(queue, NULL);
+    return PQ_SUCCESS;
+}
+
+PQElement pqGetElementByHandle(PriorityQueue queue, PQHandle handle)
+{
+    if(queue == NULL || handle == NULL)
+    {
+        return NULL;
+    }
+    return handle->element;
+}
+
+PriorityQueueResult pqChangePriorityByHandle(PriorityQueue queue, PQHandle handle, PQElementPriority new_priority)
+{
+    if(queue == NULL || handle == NULL || new_priority == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    if(isInline(queue))
+    {
+        reinsertNode(queue, handle, NULL, new_priority);
+        return PQ_SUCCESS;
+    }
+    PQElementPriority priority_copy = queue->copyPriorityFunction(new_priority);
+    if(priority_copy == NULL)
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    reinsertNode(queue, handle, NULL, priority_copy);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqRemoveByHandle(PriorityQueue queue, PQHandle handle)
+{
+    if(queue == NULL || handle == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(queue->removed_fraction > 0)
+    {
+        buryNode(queue, handle);
+        return PQ_SUCCESS;
+    }
+    detachNode(queue, handle);
+    destroyNode(queue, handle);
+    return PQ_SUCCESS;
+}
+
+bool pqContains(PriorityQueue queue, PQElement element)
+{
+    if(!queue || !element)
+    {
+        return false;
+    }
+    return findNode(queue, element, NULL) != NULL;
+}
+
+PQElement pqFind(PriorityQueue queue, PQElement element)
+{
+    if(!queue || !element)
+    {
+        return NULL;
+    }
+    Node node = findNode(queue, element, NULL);
+    return node == NULL ? NULL : node->element;
+}
+
+PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element)
+{
+    if(!queue || !element)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    Node node = findNode(queue, element, NULL);
+    if(!node)
+    {
+        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    }
+    if(queue->removed_fraction > 0)
+    {
+        buryNode(queue, node);
+        return PQ_SUCCESS;
+    }
+    detachNode(queue, node);
+    destroyNode(queue, node);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqChangePriority(PriorityQueue     queue,
+									 PQElement     	   element,
+                                     PQElementPriority old_priority,
+									 PQElementPriority new_priority)
+{
+    if(!queue || !element || !old_priority || !new_priority)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    Node node = findNode(queue, element, old_priority);
+    if(!node)
+    {
+        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    }
+    //the node is reinserted holding copies of the given element and priority
+    if(isInline(queue))
+    {
+        reinsertNode(queue, node, element, new_priority);
+        return PQ_SUCCESS;
+    }
+    PQElement element_copy = queue->copyElementFunction(element);
+    if(element_copy == NULL)
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    PQElementPriority priority_copy = queue->copyPriorityFunction(new_priority);
+    if(priority_copy == NULL)
+    {
+        queue->freeElementFunction(element_copy);
+        return PQ_OUT_OF_MEMORY;
+    }
+    reinsertNode(queue, node, element_copy, priority_copy);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqRemove(PriorityQueue queue)
+{
+    if (!queue)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    Node first = firstNode(queue);
+    if(first == NULL)
+    {
+        assert(queue->size == 0);
+        return PQ_SUCCESS;
+    }
+    detachNode(queue, first);
+    destroyNode(queue, first);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult pqPopFirst(PriorityQueue queue, PQElement* element, PQElementPriority* priority)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    Node first = firstNode(queue);
+    if(first == NULL)
+    {
+        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    }
+    if(isInline(queue))
+    {
+        return popInlineNode(queue, first, element, priority);
+    }
+    detachNode(queue, first);
+    if(element != NULL)
+    {
+        *element = first->element;
+    }
+    else
+    {
+        queue->freeElementFunction(first->element);
+    }
+    if(priority != NULL)
+    {
+        *priority = first->element_priority;
+    }
+    else
+    {
+        queue->freeElementPriority(first->element_priority);
+    }
+    releaseNode(queue, first);
+    return PQ_SUCCESS;
+}
+
+int pqPopWhile(PriorityQueue queue, PQPopPredicate predicate, void* context,
+               PQElement* elements, PQElementPriority* priorities, int max)
+{
+    if(queue == NULL || predicate == NULL || elements == NULL)
+    {
+        return -1;
+    }
+    queue->iterator_current_position = NULL;
+    int count = 0;
+    Node first = firstNode(queue);
+    while(count < max && first != NULL && predicate(first->element, first->element_priority, context))
+    {
+        if(pqPopFirst(queue, &elements[count], priorities == NULL ? NULL : &priorities[count]) != PQ_SUCCESS)
+        {
+            break; //only inline queues allocate while popping
+        }
+        count++;
+        first = firstNode(queue);
+    }
+    return count;
+}
+
+//keeps the node that comes last among the visited ones
+static void lastNodeVisitor(PriorityQueue queue, Node node, void* context)
+{
+    Node* last = context;
+    if(!node->removed && (*last == NULL || pqNodeBefore(queue, *last, node)))
+    {
+        *last = node;
+    }
+}
+
+//returns the node that comes last in the queue's order, NULL if the queue is empty.
+//On engines with a last operation the lazily removed nodes at the end are unlinked on the way,
+//the others skip them and leave them linked
+static Node lastNode(PriorityQueue queue)
+{
+    if(queue->engine->last != NULL)
+    {
+        Node last = queue->engine->last(queue);
+        while(last != NULL && last->removed)
+        {
+            purgeNode(queue, last);
+            last = queue->engine->last(queue);
+        }
+        return last;
+    }
+    Node last = NULL;
+    queue->engine->visitAll(queue, lastNodeVisitor, &last);
+    return last;
+}
+
+//like lastNode, but leaves the lazily removed nodes linked, so the iterator and the snapshot stay valid.
+//With no way back from the engine's last node, a removed one there makes it look at every node
+static Node peekLastNode(PriorityQueue queue)
+{
+    if(queue->engine->last != NULL)
+    {
+        Node last = queue->engine->last(queue);
+        if(last == NULL || !last->removed)
+        {
+            return last;
+        }
+    }
+    Node last = NULL;
+    queue->engine->visitAll(queue, lastNodeVisitor, &last);
+    return last;
+}
+
+//removes the last nodes of a bounded queue until it is back within its bound.
+//Returns false if kept was one of the removed nodes
+static bool trimToBound(PriorityQueue queue, Node kept)
+{
+    bool kept_survived = true;
+    while(queue->bound > 0 && liveSize(queue) > queue->bound)
+    {
+        Node last = lastNode(queue);
+        if(last == kept)
+        {
+            kept_survived = false;
+        }
+        detachNode(queue, last);
+        destroyNode(queue, last);
+    }
+    return kept_survived;
+}
+
+//returns whether an element with the given priority would be dropped from a full bounded queue
+//as soon as it was inserted. It goes after the last element if its priority is not higher
+static bool isBeyondBound(PriorityQueue queue, PQElementPriority priority)
+{
+    if(queue->bound <= 0 || liveSize(queue) < queue->bound)
+    {
+        return false;
+    }
+    Node last = lastNode(queue);
+    return queue->comparePrioritiesFunction(priority, last->element_priority) <= 0;
+}
+
+//returns the number of elements, the linked nodes that were not removed lazily
+static int liveSize(PriorityQueue queue)
+{
+    return queue->size - queue->removed_count;
+}
+
+//returns the first node that was not removed lazily, unlinking the removed ones in front of it
+static Node firstNode(PriorityQueue queue)
+{
+    Node first = queue->engine->first(queue);
+    while(first != NULL && first->removed)
+    {
+        purgeNode(queue, first);
+        first = queue->engine->first(queue);
+    }
+    return first;
+}
+
+//like firstNode, but leaves the lazily removed nodes linked and walks past them in order
+static Node peekFirstNode(PriorityQueue queue)
+{
+    Node first = queue->engine->first(queue);
+    return first != NULL && first->removed ? nodeSuccessor(queue, first) : first;
+}
+
+//removes a node lazily: its element is freed and it leaves the hash index, but it stays linked in
+//the engine until it reaches an end of the queue or a compaction. The snapshot stays usable
+static void buryNode(PriorityQueue queue, Node node)
+{
+    queue->iterator_current_position = NULL;
+    hashIndexRemove(queue, node);
+    if(!isInline(queue))
+    {
+        queue->freeElementFunction(node->element);
+    }
+    node->removed = true;
+    queue->removed_count++;
+    if(queue->removed_count > queue->removed_fraction * queue->size)
+    {
+        compactQueue(queue);
+    }
+}
+
+//unlinks a lazily removed node and frees what is left of it
+static void purgeNode(PriorityQueue queue, Node node)
+{
+    invalidateIterator(queue);
+    queue->engine->detach(queue, node);
+    queue->size--;
+    queue->removed_count--;
+    destroyNode(queue, node);
+}
+
+static void collectRemovedNodeVisitor(PriorityQueue queue, Node node, void* context)
+{
+    if(node->removed)
+    {
+        collectNodeVisitor(queue, node, context);
+    }
+}
+
+//unlinks all the lazily removed nodes. If the allocation fails they stay, they are skipped anyway
+static void compactQueue(PriorityQueue queue)
+{
+    if(queue->removed_count == 0)
+    {
+        return;
+    }
+    Node* removed = malloc(sizeof(*removed) * queue->removed_count);
+    if(removed == NULL)
+    {
+        return;
+    }
+    NodeCollection collection = {removed, 0};
+    queue->engine->visitAll(queue, collectRemovedNodeVisitor, &collection);
+    for(int i = 0; i < collection.count; i++)
+    {
+        purgeNode(queue, removed[i]);
+    }
+    free(removed);
+}
+
+PQElement pqGetLast(PriorityQueue queue)
+{
+    if(queue == NULL || queue->size == 0)
+    {
+        return NULL;
+    }
+    Node last = peekLastNode(queue);
+    return last == NULL ? NULL : last->element;
+}
+
+PriorityQueueResult pqRemoveLast(PriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    queue->iterator_current_position = NULL;
+    Node last = lastNode(queue);
+    if(last == NULL)
+    {
+        //engines that can not find their last node leave the removed nodes linked, only they are left
+        assert(liveSize(queue) == 0);
+        compactQueue(queue);
+        return PQ_SUCCESS;
+    }
+    detachNode(queue, last);
+    destroyNode(queue, last);
+    return PQ_SUCCESS;
+}
+
+PQElement pqGetFirst(PriorityQueue queue)
+{
+    if(queue == NULL || queue->size == 0)
+    {
+        return NULL;
+    }
+    queue->iterator_current_position = firstNode(queue);
+    if(queue->iterator_current_position == NULL)
+    {
+        return NULL;
+    }
+    return queue->iterator_current_position->element;
+}
+
+PQElement pqGetNext(PriorityQueue queue)
+{
+    if(queue == NULL || queue->size == 0)
+    {
+        return NULL;
+    }
+    if(queue->iterator_current_position == NULL)
+    {
+        return NULL;
+    }
+    queue->iterator_current_position = nodeSuccessor(queue, queue->iterator_current_position);
+    if(queue->iterator_current_position == NULL)
+    {
+        return NULL;
     }
     return queue->iterator_current_position->element;
-}
\ No newline at end of file
+}
+
+PQElement pqCursorBegin(PriorityQueue queue, PQCursor* cursor)
+{
+    if(queue == NULL || cursor == NULL)
+    {
+        return NULL;
+    }
+    cursor->queue = queue;
+    cursor->current = NULL;
+    cursor->following = NULL;
+    Node first = peekFirstNode(queue);
+    if(queue->engine->successor == NULL && !queue->snapshot_valid && !buildSnapshot(queue))
+    {
+        return NULL;
+    }
+    cursor->current = first;
+    return cursor->current == NULL ? NULL : cursor->current->element;
+}
+
+PQElement pqCursorNext(PQCursor* cursor)
+{
+    if(cursor == NULL || cursor->queue == NULL)
+    {
+        return NULL;
+    }
+    if(cursor->current != NULL)
+    {
+        cursor->current = nodeSuccessor(cursor->queue, cursor->current);
+    }
+    else
+    {
+        cursor->current = cursor->following;
+        cursor->following = NULL;
+    }
+    return cursor->current == NULL ? NULL : cursor->current->element;
+}
+
+PriorityQueueResult pqCursorRemoveCurrent(PQCursor* cursor)
+{
+    if(cursor == NULL || cursor->queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(cursor->current == NULL)
+    {
+        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    }
+    PriorityQueue queue = cursor->queue;
+    Node node = cursor->current;
+    cursor->following = nodeSuccessor(queue, node);
+    cursor->current = NULL;
+    bool snapshot_valid = queue->snapshot_valid;
+    detachNode(queue, node);
+    if(queue->engine->successor == NULL && snapshot_valid)
+    {
+        //only this node left the order, the snapshot stays usable without it
+        queue->ordered_snapshot[node->rank] = NULL;
+        queue->snapshot_valid = true;
+    }
+    destroyNode(queue, node);
+    return PQ_SUCCESS;
+}
+
+//returns whether the nodes of source can be kept by destination: same order, same way of freeing them
+static bool canMerge(PriorityQueue destination, PriorityQueue source)
+{
+    return destination->comparePrioritiesFunction == source->comparePrioritiesFunction &&
+           destination->freeElementFunction == source->freeElementFunction &&
+           destination->freeElementPriority == source->freeElementPriority &&
+           destination->element_size == source->element_size &&
+           destination->priority_size == source->priority_size;
+}
+
+//moves a node of a merged queue after the destination's nodes in insertion order, and indexes it there
+static void stampMergedNodeVisitor(PriorityQueue queue, Node node, void* context)
+{
+    PriorityQueue destination = context;
+    node->sequence += destination->next_sequence;
+    if(!node->removed)
+    {
+        hashIndexAdd(destination, node);
+    }
+}
+
+//hands all the chunks of source, with the nodes in them, over to destination
+static void moveNodePool(PriorityQueue destination, PriorityQueue source)
+{
+    if(source->node_chunks == NULL)
+    {
+        return;
+    }
+    NodeChunk last_chunk = source->node_chunks;
+    while(last_chunk->next != NULL)
+    {
+        last_chunk = last_chunk->next;
+    }
+    last_chunk->next = destination->node_chunks;
+    destination->node_chunks = source->node_chunks;
+    if(source->free_nodes != NULL)
+    {
+        Node last_free = source->free_nodes;
+        while(last_free->next != NULL)
+        {
+            last_free = last_free->next;
+        }
+        last_free->next = destination->free_nodes;
+        destination->free_nodes = source->free_nodes;
+    }
+    destination->free_node_count += source->free_node_count;
+    destination->node_capacity += source->node_capacity;
+    source->node_chunks = NULL;
+    source->free_nodes = NULL;
+    source->free_node_count = 0;
+    source->node_capacity = 0;
+}
+
+PriorityQueueResult pqMerge(PriorityQueue destination, PriorityQueue source)
+{
+    if(destination == NULL || source == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(!canMerge(destination, source))
+    {
+        return PQ_ERROR;
+    }
+    destination->iterator_current_position = NULL;
+    source->iterator_current_position = NULL;
+    if(destination == source || source->size == 0)
+    {
+        return PQ_SUCCESS;
+    }
+    if(destination->engine == source->engine && destination->engine->meld != NULL)
+    {
+        source->engine->visitAll(source, stampMergedNodeVisitor, destination);
+        destination->engine->meld(destination, source);
+    }
+    else
+    {
+        Node* nodes = malloc(sizeof(*nodes) * source->size);
+        if(nodes == NULL)
+        {
+            return PQ_OUT_OF_MEMORY;
+        }
+        NodeCollection collection = {nodes, 0};
+        source->engine->visitAll(source, collectNodeVisitor, &collection);
+        for(int i = 0; i < source->size; i++)
+        {
+            nodes[i]->sequence += destination->next_sequence;
+        }
+        if(!linkBatch(destination, nodes, source->size))
+        {
+            for(int i = 0; i < source->size; i++)
+            {
+                nodes[i]->sequence -= destination->next_sequence;
+            }
+            free(nodes);
+            return PQ_OUT_OF_MEMORY;
+        }
+        source->engine->reset(source);
+        for(int i = 0; i < source->size; i++)
+        {
+            if(!nodes[i]->removed)
+            {
+                hashIndexAdd(destination, nodes[i]);
+            }
+        }
+        free(nodes);
+    }
+    invalidateIterator(destination);
+    invalidateIterator(source);
+    hashIndexReset(source);
+    destination->next_sequence += source->next_sequence;
+    destination->size += source->size;
+    destination->removed_count += source->removed_count;
+    source->size = 0;
+    source->removed_count = 0;
+    moveNodePool(destination, source);
+    trimToBound(destination, NULL);
+    if(destination->removed_count > destination->removed_fraction * destination->size)
+    {
+        compactQueue(destination);
+    }
+    return PQ_SUCCESS;
+}
+
+//adds a node to a frontier, marks the frontier failed if it could not grow
+static void frontierPushVisitor(PriorityQueue queue, Node node, void* context)
+{
+    NodeFrontier* frontier = context;
+    if(frontier->count == frontier->capacity)
+    {
+        int new_capacity = frontier->capacity * FRONTIER_GROWTH_FACTOR;
+        Node* new_nodes = realloc(frontier->nodes, sizeof(*new_nodes) * new_capacity);
+        if(new_nodes == NULL)
+        {
+            frontier->failed = true;
+            return;
+        }
+        frontier->nodes = new_nodes;
+        frontier->capacity = new_capacity;
+    }
+    int index = frontier->count++;
+    while(index > 0 && pqNodeBefore(queue, node, frontier->nodes[(index - 1) / 2]))
+    {
+        frontier->nodes[index] = frontier->nodes[(index - 1) / 2];
+        index = (index - 1) / 2;
+    }
+    frontier->nodes[index] = node;
+}
+
+//removes and returns the node of a frontier that comes first
+static Node frontierPop(PriorityQueue queue, NodeFrontier* frontier)
+{
+    Node first = frontier->nodes[0];
+    Node last = frontier->nodes[--frontier->count];
+    int index = 0;
+    while(2 * index + 1 < frontier->count)
+    {
+        int child = 2 * index + 1;
+        if(child + 1 < frontier->count && pqNodeBefore(queue, frontier->nodes[child + 1], frontier->nodes[child]))
+        {
+            child++;
+        }
+        if(!pqNodeBefore(queue, frontier->nodes[child], last))
+        {
+            break;
+        }
+        frontier->nodes[index] = frontier->nodes[child];
+        index = child;
+    }
+    frontier->nodes[index] = last;
+    return first;
+}
+
+//reads the first count nodes of a tree shaped engine: the next node is always the first of the frontier,
+//the children of the nodes read so far that were not read yet. O(count log count) for a binary tree
+static bool collectFirstNodesOfTree(PriorityQueue queue, Node* nodes, int count)
+{
+    NodeFrontier frontier = {malloc(sizeof(Node) * FRONTIER_INITIAL_CAPACITY), 0, FRONTIER_INITIAL_CAPACITY, false};
+    if(frontier.nodes == NULL)
+    {
+        return false;
+    }
+    frontierPushVisitor(queue, queue->engine->first(queue), &frontier);
+    int collected = 0;
+    while(collected < count && !frontier.failed)
+    {
+        Node node = frontierPop(queue, &frontier);
+        queue->engine->visitChildren(queue, node, frontierPushVisitor, &frontier);
+        if(!node->removed)
+        {
+            nodes[collected++] = node;
+        }
+    }
+    free(frontier.nodes);
+    return !frontier.failed;
+}
+
+//writes the first count nodes of queue in priority order into nodes without changing anything in queue,
+//not even the iterator or the snapshot. Returns count, or -1 if an allocation failed
+static int collectFirstNodes(PriorityQueue queue, Node* nodes, int count)
+{
+    if(count == 0)
+    {
+        return 0;
+    }
+    if(queue->engine->successor != NULL)
+    {
+        int collected = 0;
+        for(Node current = queue->engine->first(queue); collected < count;
+            current = queue->engine->successor(queue, current))
+        {
+            if(!current->removed)
+            {
+                nodes[collected++] = current;
+            }
+        }
+        return count;
+    }
+    if(queue->engine->visitChildren != NULL)
+    {
+        return collectFirstNodesOfTree(queue, nodes, count) ? count : -1;
+    }
+    //every engine knows its first node, unless it was removed lazily
+    Node first = queue->engine->first(queue);
+    if(count == 1 && !first->removed)
+    {
+        nodes[0] = first;
+        return count;
+    }
+    //no shortcut, sort a private copy of all the nodes
+    Node* all = malloc(sizeof(*all) * queue->size * 2);
+    if(all == NULL)
+    {
+        return -1;
+    }
+    NodeCollection collection = {all, 0};
+    queue->engine->visitAll(queue, collectNodeVisitor, &collection);
+    pqSortNodes(queue, all, all + queue->size, queue->size);
+    int collected = 0;
+    for(int i = 0; collected < count; i++)
+    {
+        if(!all[i]->removed)
+        {
+            nodes[collected++] = all[i];
+        }
+    }
+    free(all);
+    return count;
+}
+
+int pqPeekTopK(PriorityQueue queue, int k, PQElement* elements, PQElementPriority* priorities)
+{
+    if(queue == NULL || elements == NULL)
+    {
+        return -1;
+    }
+    int count = k < liveSize(queue) ? k : liveSize(queue);
+    if(count <= 0)
+    {
+        return 0;
+    }
+    Node* nodes = malloc(sizeof(*nodes) * count);
+    if(nodes == NULL || collectFirstNodes(queue, nodes, count) < 0)
+    {
+        free(nodes);
+        return -1;
+    }
+    for(int i = 0; i < count; i++)
+    {
+        elements[i] = nodes[i]->element;
+        if(priorities != NULL)
+        {
+            priorities[i] = nodes[i]->element_priority;
+        }
+    }
+    free(nodes);
+    return count;
+}
+
+int pqToSortedArray(PriorityQueue queue, PQElement** elements, PQElementPriority** priorities)
+{
+    if(queue == NULL || elements == NULL)
+    {
+        return -1;
+    }
+    int size = liveSize(queue);
+    //one slot at least, so that an empty queue also gets arrays to free
+    *elements = malloc(sizeof(**elements) * (size > 0 ? size : 1));
+    PQElementPriority* priorities_array = NULL;
+    if(priorities != NULL)
+    {
+        priorities_array = malloc(sizeof(*priorities_array) * (size > 0 ? size : 1));
+    }
+    if(*elements == NULL || (priorities != NULL && priorities_array == NULL) ||
+       pqPeekTopK(queue, size, *elements, priorities_array) != size)
+    {
+        free(*elements);
+        free(priorities_array);
+        *elements = NULL;
+        return -1;
+    }
+    if(priorities != NULL)
+    {
+        *priorities = priorities_array;
+    }
+    return size;
+}
@@ -2,6 +2,7 @@
 #define PRIORITY_QUEUE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
 * Generic Priority Queue Container
@@ -13,27 +14,81 @@
 *
 * The following functions are available:
 *   pqCreate		    - Creates a new empty priority queue
+*   pqCreateWithBackend - Creates a new empty priority queue stored by a chosen engine
+*   pqCreateHashed      - Creates a new empty priority queue that indexes its elements by hash
+*   pqCreateKeyed       - Creates a new empty priority queue that also knows integer keys of the priorities
+*   pqCreateInline      - Creates a new empty priority queue that keeps fixed size elements and priorities in place
+*   pqCreateBounded     - Creates a new empty priority queue that drops its lowest element when it overflows
 *   pqDestroy		    - Deletes an existing priority queue and frees all resources
 *   pqCopy		        - Copies an existing priority queue
 *   pqGetSize		    - Returns the size of a given priority queue
+*   pqReserve		    - Preallocates room for a given number of elements
+*   pqSetLazyRemoval    - Makes removals mark elements as removed, and unlink them later in bulk
+*   pqMerge		        - Moves all the elements of one priority queue into another
+*   				        Iterator value is undefined after this operation.
 *   pqContains	        - returns whether or not an element exists inside the priority queue.
+*   pqFind	            - returns the element inside the priority queue that is equal to a given element.
 *   pqInsert	        - Insert an element with a given priority to the queue.
 *   				        Duplication in the priority queue is allowed.
 *   				        Iterator value is undefined after this operation.
+*   pqInsertWithHandle  - Like pqInsert, also returns a handle to the inserted element.
+*   pqInsertNoCopy      - Like pqInsertWithHandle, hands the element and priority over to the queue instead of copying them.
+*   pqInsertBatch       - Inserts many elements at once, all of them or none.
+*   				        Iterator value is undefined after this operation.
 *   pqChangePriority  	- Changes priority of an element with specific priority
 *					        Iterator value is undefined after this operation.
+*   pqChangePriorityByHandle - Changes priority of the element a handle refers to, without searching for it.
+*					        Iterator value is undefined after this operation.
+*   pqGetElementByHandle - Returns the element a handle refers to.
 *   pqRemove		    - Removes the highest priority element in the queue
 *                           Iterator value is undefined after this operation.
+*   pqRemoveLast        - Removes the lowest priority element in the queue
+*                           Iterator value is undefined after this operation.
+*   pqRemoveByHandle    - Removes the element a handle refers to, without searching for it.
+*                           Iterator value is undefined after this operation.
+*   pqPopFirst          - Removes the highest priority element and hands it over to the caller
+*                           Iterator value is undefined after this operation.
+*   pqPopWhile          - Pops elements as long as the first one satisfies a predicate
+*                           Iterator value is undefined after this operation.
 *   pqGetFirst	        - Sets the internal iterator to the first element in the priority queue and returns it
 *   pqGetNext		    - Advances the internal iterator to the next key and returns it.
+*   pqGetLast           - Returns the last element in the priority queue
+*   pqPeekTopK          - Returns the first elements of the priority queue without changing anything
+*   pqToSortedArray     - Returns all the elements of the priority queue in order without changing anything
+*   pqCursorBegin       - Sets an external cursor to the first element in the priority queue and returns it
+*   pqCursorNext        - Advances an external cursor to the next element and returns it
+*   pqCursorRemoveCurrent - Removes the element a cursor is on, the cursor stays valid
 *	pqClear		        - Clears the contents of the priority queue. Frees all the elements of
 *	 				        the queue using the free function.
 * 	PQ_FOREACH	        - A macro for iterating over the priority queue's elements.
+* 	PQ_CURSOR_FOREACH   - A macro for iterating over the priority queue's elements with a cursor.
 */
 
 /** Type for defining the priority queue */
 typedef struct PriorityQueue_t *PriorityQueue;
 
+/**
+* Handle to an element inside a priority queue, returned by pqInsertWithHandle.
+* A handle stays valid until its element is removed from the queue (by any function,
+* including pqClear and pqDestroy) and only refers to the queue that returned it.
+* Using a handle that is no longer valid is undefined.
+*/
+typedef struct PQNode_t *PQHandle;
+
+/**
+* External iterator over a priority queue, set by pqCursorBegin. Any number of cursors may
+* walk the same queue at once, and none of them moves the internal iterator.
+* Removing the current element through a cursor keeps that cursor valid. Any other change
+* to the queue, including a removal through another cursor, makes the cursor invalid until
+* pqCursorBegin is called on it again.
+* The fields belong to the priority queue, a cursor is only declared by its user.
+*/
+typedef struct PQCursor_t {
+    PriorityQueue queue;
+    PQHandle current;   //NULL once the current element was removed
+    PQHandle following; //the element after the removed one
+} PQCursor;
+
 /** Type used for returning error codes from priority queue functions */
 typedef enum PriorityQueueResult_t {
     PQ_SUCCESS,
@@ -44,6 +99,52 @@ typedef enum PriorityQueueResult_t {
     PQ_ERROR
 } PriorityQueueResult;
 
+/**
+* Storage engines a priority queue can be created with. All of them keep the same
+* order (highest priority first, insertion order between equal priorities).
+*   PQ_BACKEND_LIST        - Sorted linked list. O(n) insert, O(1) remove and iteration step.
+*   PQ_BACKEND_BINARY_HEAP - Array backed binary heap. O(log n) insert and remove.
+*                            Iterating sorts the queue once, on the first pqGetNext.
+*   PQ_BACKEND_PAIRING_HEAP - Pairing heap. O(1) insert and pqMerge, O(log n) amortized remove.
+*                            Iterating sorts the queue once, on the first pqGetNext.
+*   PQ_BACKEND_MIN_MAX_HEAP - Min-max heap. O(log n) insert, remove and pqRemoveLast, O(1) pqGetLast.
+*                            Iterating sorts the queue once, on the first pqGetNext.
+*   PQ_BACKEND_SKIPLIST    - Skiplist. O(log n) expected insert, remove and priority change,
+*                            O(1) iteration step without sorting. For queues that are iterated in
+*                            order, where PQ_BACKEND_LIST would insert too slowly.
+*   PQ_BACKEND_4_ARY_HEAP, PQ_BACKEND_8_ARY_HEAP - Array backed heaps with 4 or 8 children per
+*                            element, each group of children in one cache line. O(log n) insert
+*                            and remove like the binary heap, with fewer cache misses per pop in
+*                            queues too large for the cache and more comparisons in small ones.
+*                            Iterating sorts the queue once, on the first pqGetNext.
+*   PQ_BACKEND_RADIX_HEAP  - Radix heap over integer keys of the priorities, for monotone queues
+*                            that never get an element before the last one popped, like timers.
+*                            O(1) insert, and O(1) remove of the first element plus O(log C)
+*                            amortized, C being the range of the keys. Only pqCreateKeyed makes it.
+*                            An element before the last one popped costs O(n) to insert.
+*                            Iterating sorts the queue once, on the first pqGetNext.
+*   PQ_BACKEND_CALENDAR_QUEUE - Calendar queue over integer keys of the priorities: buckets of
+*                            keys, one per day of a rolling year, for priorities that cluster ahead
+*                            of the first element, like upcoming dates. O(1) average insert and
+*                            remove while the days fit the keys, the calendar is resized to keep
+*                            them fitting. Elements before the first one cost nothing extra.
+*                            Only pqCreateKeyed makes it.
+*                            Iterating sorts the queue once, on the first pqGetNext.
+* PQ_BACKEND_LIST and PQ_BACKEND_SKIPLIST also find the last element in O(1), the heaps other than
+* PQ_BACKEND_MIN_MAX_HEAP go over all the elements.
+*/
+typedef enum PQBackend_t {
+    PQ_BACKEND_LIST,
+    PQ_BACKEND_BINARY_HEAP,
+    PQ_BACKEND_PAIRING_HEAP,
+    PQ_BACKEND_MIN_MAX_HEAP,
+    PQ_BACKEND_SKIPLIST,
+    PQ_BACKEND_4_ARY_HEAP,
+    PQ_BACKEND_8_ARY_HEAP,
+    PQ_BACKEND_RADIX_HEAP,
+    PQ_BACKEND_CALENDAR_QUEUE
+} PQBackend;
+
 /** Data element data type for priority queue container */
 typedef void *PQElement;
 
@@ -72,6 +173,20 @@ typedef void(*FreePQElementPriority)(PQElementPriority);
 typedef bool(*EqualPQElements)(PQElement, PQElement);
 
 
+/**
+* Type of function used by the priority queue to hash elements.
+* Elements that are equal by EqualPQElements must have the same hash.
+*/
+typedef unsigned long(*HashPQElement)(PQElement);
+
+
+/**
+* Type of function used by the priority queue to map priorities to integer keys.
+* A priority that comes first must have the smaller key, and equal priorities equal keys.
+*/
+typedef long(*PQPriorityKey)(PQElementPriority);
+
+
 /**
 * Type of function used by the priority queue to compare priorities.
 * This function should return:
@@ -82,6 +197,16 @@ typedef bool(*EqualPQElements)(PQElement, PQElement);
 typedef int(*ComparePQElementPriorities)(PQElementPriority, PQElementPriority);
 
 
+/**
+* Type of function used by pqPopWhile to decide whether to pop the first element.
+* Gets the element, its priority and the context given to pqPopWhile.
+* This function should return:
+* 		true if the element should be popped;
+*		false to stop popping.
+*/
+typedef bool(*PQPopPredicate)(PQElement, PQElementPriority, void*);
+
+
 /**
 * pqCreate: Allocates a new empty priority queue.
 *
@@ -108,6 +233,119 @@ PriorityQueue pqCreate(CopyPQElement copy_element,
                        FreePQElementPriority free_priority,
                        ComparePQElementPriorities compare_priorities);
 
+/**
+* pqCreateWithBackend: Allocates a new empty priority queue that is stored by the given engine.
+* pqCreate uses PQ_DEFAULT_BACKEND, which is PQ_BACKEND_LIST unless defined otherwise at compile time.
+*
+* @param backend - The storage engine of the new priority queue.
+* The other parameters are the same as in pqCreate.
+* @return
+* 	NULL - if the backend is unknown or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateWithBackend(PQBackend backend,
+                                  CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  EqualPQElements equal_elements,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities);
+
+/**
+* pqCreateHashed: Allocates a new empty priority queue that keeps a hash index of its elements.
+* pqContains, pqFind, pqRemoveElement and pqChangePriority then find elements in O(1) on average
+* instead of going over the whole priority queue.
+*
+* @param backend - The storage engine of the new priority queue.
+* @param hash_element - Function pointer to be used for hashing elements. If NULL, the priority
+*       queue keeps no index and behaves as if it was created by pqCreateWithBackend.
+* The other parameters are the same as in pqCreate.
+* @return
+* 	NULL - if the backend is unknown or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateHashed(PQBackend backend,
+                             CopyPQElement copy_element,
+                             FreePQElement free_element,
+                             EqualPQElements equal_elements,
+                             HashPQElement hash_element,
+                             CopyPQElementPriority copy_priority,
+                             FreePQElementPriority free_priority,
+                             ComparePQElementPriorities compare_priorities);
+
+/**
+* pqCreateKeyed: Allocates a new empty priority queue, as pqCreateHashed does, that can also map
+* every priority to an integer key. PQ_BACKEND_RADIX_HEAP and PQ_BACKEND_CALENDAR_QUEUE order the
+* elements by their keys, and can only be created this way. The other backends ignore the keys.
+*
+* @param priority_key - Function pointer to be used for mapping priorities to keys. The keys must
+*       follow the order of compare_priorities: the priority that comes first has the smaller key.
+* The other parameters are the same as in pqCreateHashed.
+* @return
+* 	NULL - if priority_key is NULL, the backend is unknown or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateKeyed(PQBackend backend,
+                            CopyPQElement copy_element,
+                            FreePQElement free_element,
+                            EqualPQElements equal_elements,
+                            HashPQElement hash_element,
+                            CopyPQElementPriority copy_priority,
+                            FreePQElementPriority free_priority,
+                            ComparePQElementPriorities compare_priorities,
+                            PQPriorityKey priority_key);
+
+/**
+* pqCreateInline: Allocates a new empty priority queue that keeps the bytes of every element and
+* priority inside the queue's own storage, next to the bookkeeping of the element. Inserting copies
+* element_size and priority_size bytes instead of calling copy functions, and removing frees nothing
+* but the queue's storage. Suits small plain values, such as ints or pointers the queue does not own.
+* All the functions behave as usual, with these differences:
+*   - Elements and priorities returned by the priority queue point into its storage.
+*   - pqInsertNoCopy copies the bytes and then frees the element and priority it was handed with free.
+*   - pqPopFirst and pqPopWhile hand over copies allocated with malloc, to be freed with free.
+*     They fail with PQ_OUT_OF_MEMORY if the copies cannot be allocated.
+*
+* @param element_size - The size in bytes of an element.
+* @param priority_size - The size in bytes of a priority.
+* @param backend - The storage engine of the new priority queue.
+* @param equal_elements - Function pointer to be used for comparing elements.
+* @param hash_element - Function pointer to be used for hashing elements, may be NULL as in pqCreateHashed.
+* @param compare_priorities - Function pointer to be used for comparing priorities.
+* @return
+* 	NULL - if a size is 0, the backend is unknown or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateInline(size_t element_size,
+                             size_t priority_size,
+                             PQBackend backend,
+                             EqualPQElements equal_elements,
+                             HashPQElement hash_element,
+                             ComparePQElementPriorities compare_priorities);
+
+/**
+* pqCreateBounded: Allocates a new empty priority queue that holds at most capacity elements.
+* Whenever an insertion or pqMerge takes it over capacity, the lowest priority elements (the last
+* ones in the queue's order) are removed and freed until it is back to capacity. A new element that
+* would be the last one of a full queue is therefore dropped right away, and is not even copied.
+* PQ_BACKEND_MIN_MAX_HEAP, PQ_BACKEND_LIST and PQ_BACKEND_SKIPLIST find the element to drop in O(1).
+*
+* @param capacity - The maximal number of elements in the priority queue.
+* @param backend - The storage engine of the new priority queue.
+* The other parameters are the same as in pqCreate.
+* @return
+* 	NULL - if capacity is not positive, the backend is unknown or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateBounded(int capacity,
+                              PQBackend backend,
+                              CopyPQElement copy_element,
+                              FreePQElement free_element,
+                              EqualPQElements equal_elements,
+                              CopyPQElementPriority copy_priority,
+                              FreePQElementPriority free_priority,
+                              ComparePQElementPriorities compare_priorities);
+
 /**
 * pqDestroy: Deallocates an existing priority queue. Clears all elements by using the
 * free functions.
@@ -137,6 +375,64 @@ PriorityQueue pqCopy(PriorityQueue queue);
 */
 int pqGetSize(PriorityQueue queue);
 
+/**
+* pqReserve: Makes sure the priority queue can hold capacity elements without allocating
+* any memory of its own. Every priority queue allocates its nodes in chunks and reuses
+* the nodes of removed elements, so reserving is only worth it before bulk loads.
+* The copy functions may still allocate when inserting.
+*
+* @param queue - The priority queue to make room in.
+* @param capacity - The number of elements the priority queue should have room for.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent to the function.
+* 	PQ_OUT_OF_MEMORY if an allocation failed. Whatever was allocated is kept.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqReserve(PriorityQueue queue, int capacity);
+
+/**
+* pqSetLazyRemoval: Makes pqRemoveElement and pqRemoveByHandle remove elements lazily. A removed
+* element is freed right away, but its node stays in the queue's order, marked as removed, and is
+* skipped by everything that reads the queue. Its priority is freed once the node is unlinked:
+* when pqRemove or pqPopFirst reach it at the front of the queue, when pqRemoveLast or the trimming
+* of a bounded queue reach it at the back on the list, min-max heap and skiplist backends, or in a
+* compaction that unlinks all the removed nodes at once when more than max_removed_fraction of the
+* nodes are removed ones. pqRemoveLast also compacts a queue that only holds removed nodes.
+* Removing by handle, or by element from a queue made by pqCreateHashed, then takes O(1) amortized
+* work besides freeing, instead of unlinking every node on its own. Worth it for heaps where many
+* elements are removed long before they would come first. Other removals are never lazy.
+* Changing the setting compacts the queue if it already holds too many removed nodes.
+*
+* @param queue - The priority queue to set.
+* @param max_removed_fraction - Between 0 and 1. 0, the default, removes elements eagerly again.
+*       1 never compacts by the fraction, removed nodes are only unlinked by the removals above.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ERROR if max_removed_fraction is not between 0 and 1.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqSetLazyRemoval(PriorityQueue queue, double max_removed_fraction);
+
+/**
+* pqMerge: Moves all the elements of source into destination, without copying them, and leaves
+* source empty. Equal priorities keep their insertion order, the elements of source counting as
+* inserted after those of destination, in their own insertion order.
+* Two pairing heaps are melded in O(1) and two lists are spliced in O(n + m), other backends
+* link the elements of source as pqInsertBatch does. The elements' bookkeeping takes O(m) more.
+* Handles of elements of source become handles in destination.
+* Iterator's value is undefined for both priority queues after this operation.
+*
+* @param destination - The priority queue that receives the elements.
+* @param source - The priority queue whose elements are moved. It stays usable.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters.
+* 	PQ_ERROR if the priority queues compare or free their priorities or elements differently,
+* 	or store them inline with different sizes.
+* 	PQ_OUT_OF_MEMORY if an allocation failed. Both priority queues are unchanged.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqMerge(PriorityQueue destination, PriorityQueue source);
+
 /**
 * pqContains: Checks if an element exists in the priority queue. The element will be
 * considered in the priority queue if one of the elements in the priority queue it determined equal
@@ -151,6 +447,21 @@ int pqGetSize(PriorityQueue queue);
 */
 bool pqContains(PriorityQueue queue, PQElement element);
 
+/**
+* pqFind: Returns the element inside the priority queue that is equal to element, using the
+* comparison function used to initialize the priority queue. If there are multiple equal elements,
+* the one that comes first in the priority queue's order is returned.
+* The element is owned by the priority queue and may be modified as long as neither its equality
+* nor its priority is affected. Iterator's value is unchanged.
+*
+* @param queue - The priority queue to search in
+* @param element - The element to look for.
+* @return
+* 	NULL - if one or more of the inputs is null, or if the element was not found.
+* 	The element inside the priority queue otherwise.
+*/
+PQElement pqFind(PriorityQueue queue, PQElement element);
+
 /**
 *   pqInsert: add a specified element with a specific priority.
 *   Iterator's value is undefined after this operation.
@@ -168,6 +479,77 @@ bool pqContains(PriorityQueue queue, PQElement element);
 */
 PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPriority priority);
 
+/**
+*   pqInsertWithHandle: add a specified element with a specific priority, and return a handle to the
+*   inserted copy. The handle allows changing the priority of the element or removing it in O(log n)
+*   (O(n) for changing a priority on the list backend) without comparing elements.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The new priority to associate with the given element.
+* @param handle - Where to store the handle of the inserted element. May be NULL.
+* @return
+* 	Same as pqInsert. The handle is only assigned on PQ_SUCCESS. It is NULL if a bounded
+* 	priority queue dropped the new element right away.
+*/
+PriorityQueueResult pqInsertWithHandle(PriorityQueue queue, PQElement element, PQElementPriority priority,
+                                       PQHandle* handle);
+
+/**
+*   pqInsertNoCopy: add a specified element with a specific priority without copying them.
+*   The priority queue takes ownership of both: they are freed with the free functions
+*   given at initialization once they are removed. Use it for elements that are built only
+*   to be inserted, instead of inserting them and freeing the original.
+*   element and priority must be separate allocations.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The priority to associate with the given element.
+* @param handle - Where to store the handle of the inserted element. May be NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_OUT_OF_MEMORY if an allocation failed
+* 	PQ_SUCCESS the paired elements had been inserted successfully.
+* 	The element and the priority belong to the priority queue only on PQ_SUCCESS, and to
+* 	the caller otherwise. The handle is NULL if a bounded priority queue dropped the new element.
+*/
+PriorityQueueResult pqInsertNoCopy(PriorityQueue queue, PQElement element, PQElementPriority priority,
+                                   PQHandle* handle);
+
+/**
+*   pqInsertBatch: add count elements, each with the priority of the same index, in one go.
+*   Copies of the elements and priorities are inserted, as with pqInsert. Equal priorities keep
+*   the order of the arrays. Building the order once is cheaper than count calls to pqInsert:
+*   O(n + count) on the heap backend and O(count log count + n) on the list backend.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue for which to add the data elements
+* @param elements - The elements which need to be added.
+* @param priorities - The priorities to associate with the elements.
+* @param count - How many elements there are in the arrays.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters, or as one of the entries
+* 	PQ_ERROR if count is negative.
+* 	PQ_OUT_OF_MEMORY if an allocation failed. No element was inserted.
+* 	PQ_SUCCESS all the elements had been inserted successfully
+*/
+PriorityQueueResult pqInsertBatch(PriorityQueue queue, PQElement* elements, PQElementPriority* priorities,
+                                  int count);
+
+/**
+*   pqGetElementByHandle: Returns the element a handle refers to. The element is owned by the
+*   priority queue and may be modified as long as its priority is not affected.
+*
+* @param queue - The priority queue that returned the handle.
+* @param handle - A valid handle of that queue.
+* @return
+* 	NULL if a NULL was sent as one of the parameters.
+* 	The element otherwise.
+*/
+PQElement pqGetElementByHandle(PriorityQueue queue, PQHandle handle);
+
 /**
 *	pqChangePriority: Changes a priority of specific element with a specific priority in the priority queue.
 *           If there are multiple same elements with same priority,
@@ -189,6 +571,21 @@ PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPr
 PriorityQueueResult pqChangePriority(PriorityQueue queue, PQElement element,
                                      PQElementPriority old_priority, PQElementPriority new_priority);
 
+/**
+*	pqChangePriorityByHandle: Changes the priority of the element a handle refers to.
+*           The element is considered as reinserted and keeps its handle.
+*			Iterator's value is undefined after this operation
+*
+* @param queue - The priority queue that returned the handle.
+* @param handle - A valid handle of that queue.
+* @param new_priority - The new priority of the element. A copy is stored using the copy function.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_OUT_OF_MEMORY if copying the priority failed. The queue is unchanged.
+* 	PQ_SUCCESS the priority had been changed successfully.
+*/
+PriorityQueueResult pqChangePriorityByHandle(PriorityQueue queue, PQHandle handle, PQElementPriority new_priority);
+
 /**
 *   pqRemove: Removes the highest priority element from the priority queue.
 *   If there are multiple elements with the same highest priority, the first inserted element should be removed first.
@@ -202,6 +599,20 @@ PriorityQueueResult pqChangePriority(PriorityQueue queue, PQElement element,
 */
 PriorityQueueResult pqRemove(PriorityQueue queue);
 
+/**
+*   pqRemoveLast: Removes the lowest priority element from the priority queue.
+*   If there are multiple elements with the same lowest priority, the last inserted element is removed,
+*   so it is always the element pqGetLast returns.
+*   the element is removed and deallocated using the free functions supplied at initialization.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to remove the element from.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent to the function.
+* 	PQ_SUCCESS the least prioritized element had been removed successfully.
+*/
+PriorityQueueResult pqRemoveLast(PriorityQueue queue);
+
 /**
 *   pqRemoveElement: Removes the highest priority element from the priority queue which have its value equal to element.
 *   If there are multiple elements with the same highest priority, the first inserted element should be removed first.
@@ -220,6 +631,54 @@ PriorityQueueResult pqRemove(PriorityQueue queue);
 */
 PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element);
 
+/**
+*   pqRemoveByHandle: Removes the element a handle refers to. The element and its priority are
+*   deallocated using the free functions supplied at initialization, and the handle becomes invalid.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue that returned the handle.
+* @param handle - A valid handle of that queue.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent to the function.
+* 	PQ_SUCCESS the element had been removed successfully.
+*/
+PriorityQueueResult pqRemoveByHandle(PriorityQueue queue, PQHandle handle);
+
+/**
+*   pqPopFirst: Removes the highest priority element from the priority queue without freeing it.
+*   If there are multiple elements with the same highest priority, the first inserted element is popped.
+*   The element and its priority are handed over to the caller, who becomes responsible for freeing them.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to pop the element from.
+* @param element - Where to store the popped element. If NULL, the element is freed using the free function.
+* @param priority - Where to store the popped priority. If NULL, the priority is freed using the free function.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ELEMENT_DOES_NOT_EXISTS if the priority queue is empty.
+* 	PQ_SUCCESS the most prioritized element had been popped successfully.
+*/
+PriorityQueueResult pqPopFirst(PriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+/**
+*   pqPopWhile: Pops the highest priority elements for as long as predicate accepts the first element,
+*   up to max elements. The elements are handed over to the caller in the order they were popped.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to pop the elements from.
+* @param predicate - Decides whether the current first element should be popped.
+* @param context - Passed as is to predicate.
+* @param elements - Array of at least max entries that receives the popped elements.
+* @param priorities - Array of at least max entries that receives the popped priorities. If NULL, the
+*       priorities are freed using the free function.
+* @param max - The maximal number of elements to pop.
+* @return
+* 	-1 if a NULL was sent as queue, predicate or elements.
+* 	Otherwise the number of elements popped.
+*/
+int pqPopWhile(PriorityQueue queue, PQPopPredicate predicate, void* context,
+               PQElement* elements, PQElementPriority* priorities, int max);
+
 /**
 *	pqGetFirst: Sets the internal iterator (also called current element) to
 *	the first element in the priority queue. The internal order derived from the priorities, and the tie-breaker between
@@ -234,6 +693,17 @@ PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element);
 */
 PQElement pqGetFirst(PriorityQueue queue);
 
+/**
+*	pqGetLast: Returns the last element in the priority queue's order: the lowest priority, and
+*	between equal lowest priorities the last inserted. Does not touch the internal iterator.
+*
+* @param queue - The priority queue to return the last element of.
+* @return
+* 	NULL if a NULL pointer was sent or the priority queue is empty.
+* 	The last element of the priority queue otherwise
+*/
+PQElement pqGetLast(PriorityQueue queue);
+
 /**
 *	pqGetNext: Advances the priority queue iterator to the next element and returns it.
 *
@@ -245,6 +715,78 @@ PQElement pqGetFirst(PriorityQueue queue);
 */
 PQElement pqGetNext(PriorityQueue queue);
 
+/**
+*	pqPeekTopK: Writes the k highest priority elements into elements, in priority order, without
+*	removing them. Nothing in the priority queue changes, not even the internal iterator, so any number
+*	of callers may peek at the same time as long as no one changes the queue meanwhile.
+*	O(k) on the list backend and O(k log k) on the binary and pairing heaps (O(n log n) in the worst
+*	case for the pairing heap, whose root may have many children). On the radix heap and the calendar queue O(1) for k = 1, and
+*	O(n log n) otherwise.
+*	The elements and priorities are owned by the priority queue.
+*
+* @param queue - The priority queue to peek into.
+* @param k - The maximal number of elements to return.
+* @param elements - Array of at least k entries that receives the elements.
+* @param priorities - Array of at least k entries that receives the priorities. May be NULL.
+* @return
+* 	-1 if a NULL was sent as queue or elements, or an allocation failed.
+* 	Otherwise the number of elements written, the smaller of k and the size of the queue.
+*/
+int pqPeekTopK(PriorityQueue queue, int k, PQElement* elements, PQElementPriority* priorities);
+
+/**
+*	pqToSortedArray: Returns all the elements of the priority queue in priority order, in a new array.
+*	Nothing in the priority queue changes, as with pqPeekTopK.
+*	The arrays belong to the caller, who frees them with free. The elements and priorities in them
+*	are owned by the priority queue.
+*
+* @param queue - The priority queue to export.
+* @param elements - Receives the array of elements.
+* @param priorities - Receives the array of priorities, in the same order. May be NULL.
+* @return
+* 	-1 if a NULL was sent as queue or elements, or an allocation failed. Nothing is allocated then.
+* 	Otherwise the number of elements in the arrays, the size of the queue.
+*/
+int pqToSortedArray(PriorityQueue queue, PQElement** elements, PQElementPriority** priorities);
+
+/**
+*	pqCursorBegin: Sets cursor to the first element in the priority queue, in the same order
+*	pqGetFirst uses. Does not touch the internal iterator.
+*
+* @param queue - The priority queue to iterate over.
+* @param cursor - The cursor to set.
+* @return
+* 	NULL if a NULL pointer was sent, the priority queue is empty or an allocation failed.
+* 	The first element of the priority queue otherwise
+*/
+PQElement pqCursorBegin(PriorityQueue queue, PQCursor* cursor);
+
+/**
+*	pqCursorNext: Advances cursor to the next element and returns it.
+*	After pqCursorRemoveCurrent, returns the element that followed the removed one.
+*
+* @param cursor - The cursor to advance.
+* @return
+* 	NULL if reached the end of the priority queue, or a NULL sent as argument
+* 	The next element on the priority queue in case of success
+*/
+PQElement pqCursorNext(PQCursor* cursor);
+
+/**
+*	pqCursorRemoveCurrent: Removes the element cursor is on, freeing it and its priority.
+*	The cursor stays valid, pqCursorNext continues from the element after the removed one.
+*	O(1) on the list backend, O(log n) on the others (expected, on the skiplist backend).
+*	Iterator's value is undefined after this operation.
+*
+* @param cursor - The cursor whose element to remove.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as cursor.
+* 	PQ_ELEMENT_DOES_NOT_EXISTS if the cursor is not on an element, it reached the end or its
+* 	element was already removed.
+* 	PQ_SUCCESS the element had been removed successfully.
+*/
+PriorityQueueResult pqCursorRemoveCurrent(PQCursor* cursor);
+
 /**
 * pqClear: Removes all elements and priorities from target priority queue.
 * The elements are deallocated using the stored free functions.
@@ -265,4 +807,14 @@ PriorityQueueResult pqClear(PriorityQueue queue);
         iterator ;\
         iterator = pqGetNext(queue))
 
+/*!
+* Macro for iterating over a priority queue with a cursor declared by the caller.
+* Declares a new iterator for the loop. The loop may remove the current element with
+* pqCursorRemoveCurrent(&cursor).
+*/
+#define PQ_CURSOR_FOREACH(type, iterator, cursor, queue) \
+    for(type iterator = (type) pqCursorBegin(queue, &(cursor)) ; \
+        iterator ;\
+        iterator = (type) pqCursorNext(&(cursor)))
+
 #endif /* PRIORITY_QUEUE_H_ */
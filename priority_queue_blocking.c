@@ -0,0 +1,189 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "priority_queue_blocking.h"
+
+#define MILLISECONDS_PER_SECOND 1000
+#define NANOSECONDS_PER_MILLISECOND 1000000L
+#define NANOSECONDS_PER_SECOND 1000000000L
+
+struct BlockingPriorityQueue_t
+{
+    PriorityQueue queue;
+    PQPopPredicate ready;
+    void* ready_context;
+    pthread_mutex_t lock;
+    pthread_cond_t head_ready; //signaled, one consumer at a time, when the first element is ready
+    int waiting;               //consumers waiting on head_ready
+};
+
+//returns whether the queue has a first element and it is ready. Called with the lock held
+static bool isFirstReady(BlockingPriorityQueue queue);
+
+//wakes one waiting consumer if there is one and the first element is ready. Called with the lock held
+static void wakeOneIfReady(BlockingPriorityQueue queue);
+
+//returns the moment timeout milliseconds from now, on the clock head_ready waits by
+static struct timespec deadlineAfter(long timeout);
+
+static bool isFirstReady(BlockingPriorityQueue queue)
+{
+    PQElement element = NULL;
+    PQElementPriority priority = NULL;
+    if(pqPeekTopK(queue->queue, 1, &element, &priority) == 0)
+    {
+        return false;
+    }
+    return queue->ready == NULL || queue->ready(element, priority, queue->ready_context);
+}
+
+static void wakeOneIfReady(BlockingPriorityQueue queue)
+{
+    if(queue->waiting > 0 && isFirstReady(queue))
+    {
+        pthread_cond_signal(&queue->head_ready);
+    }
+}
+
+static struct timespec deadlineAfter(long timeout)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / MILLISECONDS_PER_SECOND;
+    deadline.tv_nsec += (timeout % MILLISECONDS_PER_SECOND) * NANOSECONDS_PER_MILLISECOND;
+    if(deadline.tv_nsec >= NANOSECONDS_PER_SECOND)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= NANOSECONDS_PER_SECOND;
+    }
+    return deadline;
+}
+
+BlockingPriorityQueue bpqCreate(PriorityQueue queue, PQPopPredicate ready, void* ready_context)
+{
+    if(queue == NULL)
+    {
+        return NULL;
+    }
+    BlockingPriorityQueue blocking = malloc(sizeof(*blocking));
+    if(blocking == NULL)
+    {
+        return NULL;
+    }
+    pthread_condattr_t attributes;
+    if(pthread_condattr_init(&attributes) != 0)
+    {
+        free(blocking);
+        return NULL;
+    }
+    //timeouts are measured on the monotonic clock, so setting the time of day does not stretch them
+    bool initialized = pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC) == 0 &&
+                       pthread_cond_init(&blocking->head_ready, &attributes) == 0;
+    pthread_condattr_destroy(&attributes);
+    if(!initialized)
+    {
+        free(blocking);
+        return NULL;
+    }
+    if(pthread_mutex_init(&blocking->lock, NULL) != 0)
+    {
+        pthread_cond_destroy(&blocking->head_ready);
+        free(blocking);
+        return NULL;
+    }
+    blocking->queue = queue;
+    blocking->ready = ready;
+    blocking->ready_context = ready_context;
+    blocking->waiting = 0;
+    return blocking;
+}
+
+void bpqDestroy(BlockingPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return;
+    }
+    pqDestroy(queue->queue);
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->head_ready);
+    free(queue);
+}
+
+int bpqGetSize(BlockingPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return -1;
+    }
+    pthread_mutex_lock(&queue->lock);
+    int size = pqGetSize(queue->queue);
+    pthread_mutex_unlock(&queue->lock);
+    return size;
+}
+
+PriorityQueueResult bpqInsert(BlockingPriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    pthread_mutex_lock(&queue->lock);
+    PQHandle handle = NULL;
+    PriorityQueueResult result = pqInsertWithHandle(queue->queue, element, priority, &handle);
+    if(result == PQ_SUCCESS && handle != NULL && queue->waiting > 0)
+    {
+        //behind the first element the new one changes nothing for the consumers
+        PQElement first = NULL;
+        pqPeekTopK(queue->queue, 1, &first, NULL);
+        if(first == pqGetElementByHandle(queue->queue, handle))
+        {
+            wakeOneIfReady(queue);
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+PriorityQueueResult bpqPopWait(BlockingPriorityQueue queue, long timeout, PQElement* element,
+                               PQElementPriority* priority)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    struct timespec deadline = deadlineAfter(timeout > 0 ? timeout : 0);
+    int wait_result = 0;
+    pthread_mutex_lock(&queue->lock);
+    while(!isFirstReady(queue))
+    {
+        if(timeout == 0 || wait_result == ETIMEDOUT)
+        {
+            pthread_mutex_unlock(&queue->lock);
+            return PQ_ELEMENT_DOES_NOT_EXISTS;
+        }
+        queue->waiting++;
+        wait_result = timeout < 0 ? pthread_cond_wait(&queue->head_ready, &queue->lock)
+                                  : pthread_cond_timedwait(&queue->head_ready, &queue->lock, &deadline);
+        queue->waiting--;
+    }
+    PriorityQueueResult result = pqPopFirst(queue->queue, element, priority);
+    //the wakeup that brought this consumer here is used up, pass it on if there is more to pop
+    wakeOneIfReady(queue);
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+PriorityQueueResult bpqWakeWaiters(BlockingPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    pthread_mutex_lock(&queue->lock);
+    wakeOneIfReady(queue);
+    pthread_mutex_unlock(&queue->lock);
+    return PQ_SUCCESS;
+}
@@ -0,0 +1,107 @@
+#ifndef PRIORITY_QUEUE_BLOCKING_H
+#define PRIORITY_QUEUE_BLOCKING_H
+
+#include "priority_queue.h"
+
+/**
+* Blocking Priority Queue Container
+*
+* A thread safe wrapper around a PriorityQueue for producer and consumer threads, where
+* consumers wait for the first element to become ready instead of polling for it.
+* Whether the first element is ready is decided by a ready predicate, for example "its date
+* is not after the current date". Consumers sleep in bpqPopWait until the first element is
+* ready or their timeout runs out.
+* Waking up is kept to what is needed:
+*   - bpqInsert wakes a single consumer, and only when the new element became the first
+*     one and it is ready. Inserting behind the first element never wakes anybody.
+*   - A consumer that popped wakes the next one only if the new first element is ready too.
+*   - bpqWakeWaiters is called by whoever changes what the predicate depends on (advancing
+*     a clock, say), and wakes a consumer only if the first element became ready.
+*
+* The following functions are available:
+*   bpqCreate		    - Wraps a priority queue for use by several threads
+*   bpqDestroy		    - Deletes a blocking priority queue and the priority queue inside it
+*   bpqGetSize		    - Returns the number of elements in the queue
+*   bpqInsert	        - Insert an element with a given priority to the queue.
+*   bpqPopWait          - Waits for the first element to be ready, and hands it over to the caller
+*   bpqWakeWaiters      - Tells waiting consumers that the first element may have become ready
+*/
+
+/** Type for defining the blocking priority queue */
+typedef struct BlockingPriorityQueue_t *BlockingPriorityQueue;
+
+/**
+* bpqCreate: Wraps a priority queue so several threads can insert into it and pop from it.
+* The blocking priority queue takes over queue: it may not be used directly anymore, and
+* it is destroyed by bpqDestroy.
+*
+* @param queue - The priority queue to wrap, usually empty.
+* @param ready - Decides whether the first element can be popped, gets the element, its priority and
+*       ready_context. It is called with the queue locked, so it may not use the blocking queue.
+*       If NULL, every element is ready.
+* @param ready_context - Passed as is to ready.
+* @return
+* 	NULL - if queue is NULL or allocations failed. queue is not taken over in that case.
+* 	A new blocking priority queue in case of success.
+*/
+BlockingPriorityQueue bpqCreate(PriorityQueue queue, PQPopPredicate ready, void* ready_context);
+
+/**
+* bpqDestroy: Deallocates a blocking priority queue, and destroys the priority queue inside it.
+* No other thread may be using the queue, or waiting on it.
+*
+* @param queue - Target queue to be deallocated. If queue is NULL nothing will be done
+*/
+void bpqDestroy(BlockingPriorityQueue queue);
+
+/**
+* bpqGetSize: Returns the number of elements in a blocking priority queue.
+*
+* @param queue - The blocking priority queue whose size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the queue.
+*/
+int bpqGetSize(BlockingPriorityQueue queue);
+
+/**
+*   bpqInsert: add a copy of an element with a specific priority, as pqInsert does. If the element
+*   becomes the first one and it is ready, one waiting consumer is woken up.
+*
+* @param queue - The blocking priority queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The priority to associate with the given element.
+* @return
+* 	Same as pqInsert.
+*/
+PriorityQueueResult bpqInsert(BlockingPriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/**
+*   bpqPopWait: Pops the first element once it is ready, as pqPopFirst does. If it is not ready or the
+*   queue is empty, waits until it is, or until timeout milliseconds have passed.
+*
+* @param queue - The blocking priority queue to pop the element from.
+* @param timeout - The longest time to wait, in milliseconds. 0 does not wait at all, a negative
+*       timeout waits for as long as it takes.
+* @param element - Where to store the popped element. If NULL, the element is freed using the free function.
+* @param priority - Where to store the popped priority. If NULL, the priority is freed using the free function.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ELEMENT_DOES_NOT_EXISTS if no element was ready before the timeout.
+* 	Otherwise the result of pqPopFirst.
+*/
+PriorityQueueResult bpqPopWait(BlockingPriorityQueue queue, long timeout, PQElement* element,
+                               PQElementPriority* priority);
+
+/**
+*   bpqWakeWaiters: Tells the queue that what the ready predicate depends on has changed. If the
+*   first element is ready now, a waiting consumer is woken up to pop it.
+*
+* @param queue - The blocking priority queue whose consumers may pop now.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult bpqWakeWaiters(BlockingPriorityQueue queue);
+
+#endif /* PRIORITY_QUEUE_BLOCKING_H */
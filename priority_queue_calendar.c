@@ -0,0 +1,383 @@
+#include <stdlib.h>
+#include "priority_queue_internal.h"
+
+/**
+* Calendar queue engine, for queues whose priorities map to integer keys (see pqCreateKeyed)
+* and cluster in a window ahead of the first one, like the dates of upcoming events.
+* The keys are split into days of width keys each, and the days into years of bucket_count
+* days. Bucket b holds every node on day b of any year, sorted by key and insertion. The
+* engine keeps its place in the calendar, the current bucket and the key its day starts at,
+* and finds the first node by walking the buckets from there, taking a bucket's head if it is
+* on the current year. A year with nothing on it falls back to looking at every bucket.
+* The first node is kept up to date by inserting and unlinking, so looking at it changes nothing
+* and any number of readers may do it at once.
+* With about one node per day, inserting and finding the next first node are O(1) on average.
+* The calendar is resized when the number of nodes doubles or halves: the width of a day is
+* measured again from the gaps between the first nodes, and the buckets are refilled, O(n).
+* A year never grows beyond the keys that are in the queue, so many nodes on few keys do not
+* spread over empty days.
+*/
+
+#define CALENDAR_MIN_BUCKETS 16
+//the first nodes the width of a day is measured on, and how many of their gaps a day spans
+#define CALENDAR_SAMPLE 25
+#define CALENDAR_DAY_GAPS 3
+
+typedef struct CalendarBucket_t
+{
+    Node head;
+    Node tail;
+} CalendarBucket;
+
+typedef struct CalendarState_t
+{
+    CalendarBucket* buckets;
+    int bucket_count;      //a power of 2
+    unsigned long width;   //keys in a day
+    int current;           //the bucket the calendar is at
+    unsigned long day_start; //the first key of the current day, no key in the queue is before it
+    unsigned long max_key; //at least the largest key in the queue
+    Node first;            //the first node, NULL if the calendar is empty
+    int count;
+}*CalendarState;
+
+static bool calendarInit(PriorityQueue queue);
+static void calendarRelease(PriorityQueue queue);
+static bool calendarInsert(PriorityQueue queue, Node node);
+static void calendarDetach(PriorityQueue queue, Node node);
+static Node calendarFirst(PriorityQueue queue);
+static void calendarVisitAll(PriorityQueue queue, NodeVisitor visit, void* context);
+static void calendarReset(PriorityQueue queue);
+
+//returns the bucket the day of key is in
+static int calendarBucketOf(CalendarState state, unsigned long key);
+
+//moves the calendar to the day of key
+static void calendarMoveTo(CalendarState state, unsigned long key);
+
+//returns whether node a comes before node b, by key and then by insertion
+static bool calendarBefore(PriorityQueue queue, Node a, Node b);
+
+//links node into its bucket, after the nodes that come before it
+static void calendarLink(PriorityQueue queue, CalendarState state, Node node);
+
+//unlinks node from its bucket
+static void calendarUnlink(CalendarState state, Node node);
+
+//finds the first node and moves the calendar to its day, NULL if there are none
+static Node calendarFindFirst(PriorityQueue queue, CalendarState state);
+
+//remeasures the width of a day and moves the nodes into bucket_count buckets. If the allocation fails
+//the calendar stays as it was
+static void calendarResize(PriorityQueue queue, CalendarState state, int bucket_count);
+
+const PQEngine pqCalendarQueueEngine = {
+    calendarInit,
+    calendarRelease,
+    calendarInsert,
+    calendarInsert,
+    calendarDetach,
+    calendarFirst,
+    NULL,
+    calendarVisitAll,
+    calendarReset,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+static bool calendarInit(PriorityQueue queue)
+{
+    //without keys there is nothing to put the nodes on days by
+    if(queue->priorityKeyFunction == NULL)
+    {
+        return false;
+    }
+    CalendarState state = malloc(sizeof(*state));
+    if(state == NULL)
+    {
+        return false;
+    }
+    state->buckets = malloc(sizeof(*state->buckets) * CALENDAR_MIN_BUCKETS);
+    if(state->buckets == NULL)
+    {
+        free(state);
+        return false;
+    }
+    state->bucket_count = CALENDAR_MIN_BUCKETS;
+    state->width = 1;
+    queue->engine_state = state;
+    calendarReset(queue);
+    return true;
+}
+
+static void calendarRelease(PriorityQueue queue)
+{
+    CalendarState state = queue->engine_state;
+    free(state->buckets);
+    free(state);
+    queue->engine_state = NULL;
+}
+
+static int calendarBucketOf(CalendarState state, unsigned long key)
+{
+    return (int) ((key / state->width) & (unsigned long) (state->bucket_count - 1));
+}
+
+static void calendarMoveTo(CalendarState state, unsigned long key)
+{
+    state->current = calendarBucketOf(state, key);
+    state->day_start = key - key % state->width;
+}
+
+static bool calendarBefore(PriorityQueue queue, Node a, Node b)
+{
+    unsigned long key_a = pqNodeKey(queue, a);
+    unsigned long key_b = pqNodeKey(queue, b);
+    return key_a != key_b ? key_a < key_b : a->sequence < b->sequence;
+}
+
+static void calendarLink(PriorityQueue queue, CalendarState state, Node node)
+{
+    int bucket = calendarBucketOf(state, pqNodeKey(queue, node));
+    CalendarBucket* target = &state->buckets[bucket];
+    //nodes mostly come in late, so the place is looked for from the tail
+    Node previous = target->tail;
+    while(previous != NULL && calendarBefore(queue, node, previous))
+    {
+        previous = previous->prev;
+    }
+    node->index = bucket;
+    node->prev = previous;
+    node->next = previous != NULL ? previous->next : target->head;
+    if(node->next != NULL)
+    {
+        node->next->prev = node;
+    }
+    else
+    {
+        target->tail = node;
+    }
+    if(previous != NULL)
+    {
+        previous->next = node;
+    }
+    else
+    {
+        target->head = node;
+    }
+}
+
+static void calendarUnlink(CalendarState state, Node node)
+{
+    CalendarBucket* bucket = &state->buckets[node->index];
+    if(node->prev != NULL)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        bucket->head = node->next;
+    }
+    if(node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        bucket->tail = node->prev;
+    }
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+static Node calendarFindFirst(PriorityQueue queue, CalendarState state)
+{
+    if(state->count == 0)
+    {
+        return NULL;
+    }
+    //no key is before the current day, so the first head on its own year is the first node
+    int bucket = state->current;
+    unsigned long day_start = state->day_start;
+    for(int day = 0; day < state->bucket_count; day++)
+    {
+        Node head = state->buckets[bucket].head;
+        if(head != NULL && pqNodeKey(queue, head) - day_start < state->width)
+        {
+            state->current = bucket;
+            state->day_start = day_start;
+            return head;
+        }
+        bucket = (bucket + 1) & (state->bucket_count - 1);
+        //past the last day there are no keys to find, the smallest head is looked for below
+        if(day_start > ULONG_MAX - state->width)
+        {
+            break;
+        }
+        day_start += state->width;
+    }
+    //a whole year went by empty, the first node is the smallest head
+    Node first = NULL;
+    for(bucket = 0; bucket < state->bucket_count; bucket++)
+    {
+        Node head = state->buckets[bucket].head;
+        if(head != NULL && (first == NULL || calendarBefore(queue, head, first)))
+        {
+            first = head;
+        }
+    }
+    calendarMoveTo(state, pqNodeKey(queue, first));
+    return first;
+}
+
+static void calendarResize(PriorityQueue queue, CalendarState state, int bucket_count)
+{
+    //the first nodes are taken out in order, their gaps tell how far apart the nodes are
+    Node sample[CALENDAR_SAMPLE];
+    int sampled = 0;
+    while(sampled < CALENDAR_SAMPLE && sampled < state->count)
+    {
+        sample[sampled] = calendarFindFirst(queue, state);
+        calendarUnlink(state, sample[sampled]);
+        state->count--;
+        sampled++;
+    }
+    state->count += sampled;
+    unsigned long total = 0;
+    for(int i = 1; i < sampled; i++)
+    {
+        total += pqNodeKey(queue, sample[i]) - pqNodeKey(queue, sample[i - 1]);
+    }
+    //gaps much wider than the rest are outliers, they would make the days too wide
+    unsigned long average = sampled > 1 ? total / (unsigned long) (sampled - 1) : 0;
+    unsigned long close_total = 0;
+    int close_gaps = 0;
+    for(int i = 1; i < sampled; i++)
+    {
+        unsigned long gap = pqNodeKey(queue, sample[i]) - pqNodeKey(queue, sample[i - 1]);
+        if(gap <= 2 * average)
+        {
+            close_total += gap;
+            close_gaps++;
+        }
+    }
+    unsigned long width = close_gaps > 0 ? CALENDAR_DAY_GAPS * close_total / (unsigned long) close_gaps : 1;
+    CalendarBucket* buckets = malloc(sizeof(*buckets) * bucket_count);
+    CalendarBucket* old_buckets = state->buckets;
+    int old_count = state->bucket_count;
+    if(buckets != NULL)
+    {
+        for(int bucket = 0; bucket < bucket_count; bucket++)
+        {
+            buckets[bucket].head = NULL;
+            buckets[bucket].tail = NULL;
+        }
+        state->buckets = buckets;
+        state->bucket_count = bucket_count;
+        state->width = width > 0 ? width : 1;
+        for(int bucket = 0; bucket < old_count; bucket++)
+        {
+            Node current = old_buckets[bucket].head;
+            while(current != NULL)
+            {
+                Node next = current->next;
+                calendarLink(queue, state, current);
+                current = next;
+            }
+        }
+        free(old_buckets);
+    }
+    for(int i = 0; i < sampled; i++)
+    {
+        calendarLink(queue, state, sample[i]);
+    }
+    if(sampled > 0)
+    {
+        calendarMoveTo(state, pqNodeKey(queue, sample[0]));
+    }
+    state->first = sampled > 0 ? sample[0] : NULL;
+}
+
+static bool calendarInsert(PriorityQueue queue, Node node)
+{
+    CalendarState state = queue->engine_state;
+    unsigned long key = pqNodeKey(queue, node);
+    if(state->count == 0)
+    {
+        calendarMoveTo(state, key);
+        state->max_key = key;
+    }
+    else if(key < state->day_start)
+    {
+        calendarMoveTo(state, key);
+    }
+    state->max_key = key > state->max_key ? key : state->max_key;
+    calendarLink(queue, state, node);
+    if(state->first == NULL || calendarBefore(queue, node, state->first))
+    {
+        state->first = node;
+    }
+    state->count++;
+    //more buckets only help while a year does not cover every key yet
+    if(state->count > 2 * state->bucket_count &&
+       (state->max_key - state->day_start) / state->width >= (unsigned long) state->bucket_count)
+    {
+        calendarResize(queue, state, 2 * state->bucket_count);
+    }
+    return true;
+}
+
+static void calendarDetach(PriorityQueue queue, Node node)
+{
+    CalendarState state = queue->engine_state;
+    calendarUnlink(state, node);
+    state->count--;
+    //resizing finds the first node on its own
+    if(state->count < state->bucket_count / 2 && state->bucket_count > CALENDAR_MIN_BUCKETS)
+    {
+        calendarResize(queue, state, state->bucket_count / 2);
+    }
+    else if(state->first == node)
+    {
+        state->first = calendarFindFirst(queue, state);
+    }
+}
+
+static Node calendarFirst(PriorityQueue queue)
+{
+    CalendarState state = queue->engine_state;
+    return state->first;
+}
+
+static void calendarVisitAll(PriorityQueue queue, NodeVisitor visit, void* context)
+{
+    CalendarState state = queue->engine_state;
+    for(int bucket = 0; bucket < state->bucket_count; bucket++)
+    {
+        Node current = state->buckets[bucket].head;
+        while(current != NULL)
+        {
+            Node next = current->next;
+            visit(queue, current, context);
+            current = next;
+        }
+    }
+}
+
+static void calendarReset(PriorityQueue queue)
+{
+    CalendarState state = queue->engine_state;
+    for(int bucket = 0; bucket < state->bucket_count; bucket++)
+    {
+        state->buckets[bucket].head = NULL;
+        state->buckets[bucket].tail = NULL;
+    }
+    state->current = 0;
+    state->day_start = 0;
+    state->max_key = 0;
+    state->first = NULL;
+    state->count = 0;
+}
@@ -0,0 +1,445 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "priority_queue_concurrent.h"
+
+/**
+* The heap lives in slots numbered from CPQ_ROOT, the children of slot i are 2i and 2i+1.
+* Every slot has its own lock and a tag:
+*   SLOT_EMPTY     - no element.
+*   SLOT_BUSY      - the element's insertion is still moving it up. Only that insertion may
+*                    move it, it finds its element again by the element's insertion stamp.
+*   SLOT_AVAILABLE - the element is in place, pops may move it.
+* Locks are always taken from the lower slot number to the higher one, so threads never
+* wait for each other in a circle. The heap lock only guards the number of slots in use
+* and the insertion stamps.
+* The slots are allocated in segments that never move, each twice as large as the one
+* before it. Adding a segment takes the segment lock for writing, every other operation
+* holds it for reading from start to end.
+*/
+
+#define CPQ_ROOT 1
+#define CPQ_FIRST_SEGMENT_SIZE 64
+#define CPQ_MAX_SEGMENTS 24
+
+typedef enum SlotTag_t {
+    SLOT_EMPTY,
+    SLOT_BUSY,
+    SLOT_AVAILABLE
+} SlotTag;
+
+typedef struct ConcurrentSlot_t
+{
+    pthread_mutex_t lock;
+    SlotTag tag;
+    PQElement element;
+    PQElementPriority priority;
+    unsigned long sequence; //insertion stamp, the tie-breaker between equal priorities
+} ConcurrentSlot;
+
+struct ConcurrentPriorityQueue_t
+{
+    pthread_mutex_t heap_lock;
+    pthread_rwlock_t segment_lock;
+    ConcurrentSlot* segments[CPQ_MAX_SEGMENTS];
+    int segment_count;
+    int capacity;
+    int next; //the slot the next insertion takes
+    unsigned long next_sequence;
+    CopyPQElement copyElementFunction;
+    FreePQElement freeElementFunction;
+    CopyPQElementPriority copyPriorityFunction;
+    FreePQElementPriority freeElementPriority;
+    ComparePQElementPriorities comparePrioritiesFunction;
+};
+
+//returns the slot numbered index, its segment must exist
+static ConcurrentSlot* slotAt(ConcurrentPriorityQueue queue, int index);
+
+//allocates one more segment, with all of its slots empty. Called with the segment lock held for writing
+static bool addSegment(ConcurrentPriorityQueue queue);
+
+//adds segments until slot index exists
+static bool addSegmentsUpTo(ConcurrentPriorityQueue queue, int index);
+
+//returns whether the element in slot a comes before the one in slot b
+static bool slotBefore(ConcurrentPriorityQueue queue, ConcurrentSlot* a, ConcurrentSlot* b);
+
+//returns whether slot holds the element of the insertion stamped sequence, still being inserted
+static bool isOwnedBy(ConcurrentSlot* slot, unsigned long sequence);
+
+//exchanges the contents of two locked slots
+static void swapSlots(ConcurrentSlot* a, ConcurrentSlot* b);
+
+//moves the element stamped sequence up from slot child until its parent comes before it
+static void siftUp(ConcurrentPriorityQueue queue, int child, unsigned long sequence);
+
+//moves the element in the locked root down until it comes before its children, and unlocks it
+static void siftDown(ConcurrentPriorityQueue queue, ConcurrentSlot* root);
+
+static ConcurrentSlot* slotAt(ConcurrentPriorityQueue queue, int index)
+{
+    int offset = index - CPQ_ROOT;
+    int segment = 0;
+    for(int size = CPQ_FIRST_SEGMENT_SIZE; offset >= size; size *= 2)
+    {
+        offset -= size;
+        segment++;
+    }
+    return &queue->segments[segment][offset];
+}
+
+static bool addSegment(ConcurrentPriorityQueue queue)
+{
+    if(queue->segment_count == CPQ_MAX_SEGMENTS)
+    {
+        return false;
+    }
+    int size = CPQ_FIRST_SEGMENT_SIZE << queue->segment_count;
+    ConcurrentSlot* segment = malloc(sizeof(*segment) * size);
+    if(segment == NULL)
+    {
+        return false;
+    }
+    for(int i = 0; i < size; i++)
+    {
+        if(pthread_mutex_init(&segment[i].lock, NULL) != 0)
+        {
+            while(i-- > 0)
+            {
+                pthread_mutex_destroy(&segment[i].lock);
+            }
+            free(segment);
+            return false;
+        }
+        segment[i].tag = SLOT_EMPTY;
+    }
+    queue->segments[queue->segment_count++] = segment;
+    queue->capacity += size;
+    return true;
+}
+
+static bool addSegmentsUpTo(ConcurrentPriorityQueue queue, int index)
+{
+    pthread_rwlock_wrlock(&queue->segment_lock);
+    bool added = true;
+    while(added && queue->capacity < index)
+    {
+        added = addSegment(queue);
+    }
+    pthread_rwlock_unlock(&queue->segment_lock);
+    return added;
+}
+
+static bool slotBefore(ConcurrentPriorityQueue queue, ConcurrentSlot* a, ConcurrentSlot* b)
+{
+    int delta = queue->comparePrioritiesFunction(a->priority, b->priority);
+    return delta != 0 ? delta > 0 : a->sequence < b->sequence;
+}
+
+static bool isOwnedBy(ConcurrentSlot* slot, unsigned long sequence)
+{
+    return slot->tag == SLOT_BUSY && slot->sequence == sequence;
+}
+
+static void swapSlots(ConcurrentSlot* a, ConcurrentSlot* b)
+{
+    SlotTag tag = a->tag;
+    PQElement element = a->element;
+    PQElementPriority priority = a->priority;
+    unsigned long sequence = a->sequence;
+    a->tag = b->tag;
+    a->element = b->element;
+    a->priority = b->priority;
+    a->sequence = b->sequence;
+    b->tag = tag;
+    b->element = element;
+    b->priority = priority;
+    b->sequence = sequence;
+}
+
+ConcurrentPriorityQueue cpqCreate(CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities)
+{
+    if(copy_element == NULL || free_element == NULL || copy_priority == NULL || free_priority == NULL ||
+       compare_priorities == NULL)
+    {
+        return NULL;
+    }
+    ConcurrentPriorityQueue queue = malloc(sizeof(*queue));
+    if(queue == NULL)
+    {
+        return NULL;
+    }
+    if(pthread_mutex_init(&queue->heap_lock, NULL) != 0)
+    {
+        free(queue);
+        return NULL;
+    }
+    if(pthread_rwlock_init(&queue->segment_lock, NULL) != 0)
+    {
+        pthread_mutex_destroy(&queue->heap_lock);
+        free(queue);
+        return NULL;
+    }
+    queue->segment_count = 0;
+    queue->capacity = 0;
+    queue->next = CPQ_ROOT;
+    queue->next_sequence = 0;
+    queue->copyElementFunction = copy_element;
+    queue->freeElementFunction = free_element;
+    queue->copyPriorityFunction = copy_priority;
+    queue->freeElementPriority = free_priority;
+    queue->comparePrioritiesFunction = compare_priorities;
+    return queue;
+}
+
+void cpqDestroy(ConcurrentPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return;
+    }
+    for(int i = CPQ_ROOT; i < queue->next; i++)
+    {
+        ConcurrentSlot* slot = slotAt(queue, i);
+        queue->freeElementFunction(slot->element);
+        queue->freeElementPriority(slot->priority);
+    }
+    for(int s = 0; s < queue->segment_count; s++)
+    {
+        for(int i = 0; i < CPQ_FIRST_SEGMENT_SIZE << s; i++)
+        {
+            pthread_mutex_destroy(&queue->segments[s][i].lock);
+        }
+        free(queue->segments[s]);
+    }
+    pthread_rwlock_destroy(&queue->segment_lock);
+    pthread_mutex_destroy(&queue->heap_lock);
+    free(queue);
+}
+
+int cpqGetSize(ConcurrentPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return -1;
+    }
+    pthread_mutex_lock(&queue->heap_lock);
+    int size = queue->next - CPQ_ROOT;
+    pthread_mutex_unlock(&queue->heap_lock);
+    return size;
+}
+
+PriorityQueueResult cpqInsert(ConcurrentPriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+    if(queue == NULL || element == NULL || priority == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    PQElement element_copy = queue->copyElementFunction(element);
+    if(element_copy == NULL)
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    PQElementPriority priority_copy = queue->copyPriorityFunction(priority);
+    if(priority_copy == NULL)
+    {
+        queue->freeElementFunction(element_copy);
+        return PQ_OUT_OF_MEMORY;
+    }
+    pthread_rwlock_rdlock(&queue->segment_lock);
+    pthread_mutex_lock(&queue->heap_lock);
+    while(queue->next > queue->capacity)
+    {
+        int index = queue->next;
+        pthread_mutex_unlock(&queue->heap_lock);
+        pthread_rwlock_unlock(&queue->segment_lock);
+        if(!addSegmentsUpTo(queue, index))
+        {
+            queue->freeElementFunction(element_copy);
+            queue->freeElementPriority(priority_copy);
+            return PQ_OUT_OF_MEMORY;
+        }
+        pthread_rwlock_rdlock(&queue->segment_lock);
+        pthread_mutex_lock(&queue->heap_lock);
+    }
+    int child = queue->next++;
+    unsigned long sequence = queue->next_sequence++;
+    ConcurrentSlot* slot = slotAt(queue, child);
+    pthread_mutex_lock(&slot->lock);
+    pthread_mutex_unlock(&queue->heap_lock);
+    slot->tag = SLOT_BUSY;
+    slot->element = element_copy;
+    slot->priority = priority_copy;
+    slot->sequence = sequence;
+    pthread_mutex_unlock(&slot->lock);
+    siftUp(queue, child, sequence);
+    pthread_rwlock_unlock(&queue->segment_lock);
+    return PQ_SUCCESS;
+}
+
+static void siftUp(ConcurrentPriorityQueue queue, int child, unsigned long sequence)
+{
+    while(child > CPQ_ROOT)
+    {
+        int parent = child / 2;
+        ConcurrentSlot* parent_slot = slotAt(queue, parent);
+        ConcurrentSlot* child_slot = slotAt(queue, child);
+        pthread_mutex_lock(&parent_slot->lock);
+        pthread_mutex_lock(&child_slot->lock);
+        bool placed = false;
+        bool moved = true;
+        if(!isOwnedBy(child_slot, sequence))
+        {
+            //a pop took the element up, it can only be closer to the root
+            child = parent;
+        }
+        else if(parent_slot->tag == SLOT_AVAILABLE)
+        {
+            if(slotBefore(queue, child_slot, parent_slot))
+            {
+                swapSlots(child_slot, parent_slot);
+                child = parent;
+            }
+            else
+            {
+                child_slot->tag = SLOT_AVAILABLE;
+                placed = true;
+            }
+        }
+        else
+        {
+            moved = false; //the parent is still being inserted itself, wait for it to settle
+        }
+        pthread_mutex_unlock(&child_slot->lock);
+        pthread_mutex_unlock(&parent_slot->lock);
+        if(placed)
+        {
+            return;
+        }
+        if(!moved)
+        {
+            sched_yield();
+        }
+    }
+    ConcurrentSlot* root = slotAt(queue, CPQ_ROOT);
+    pthread_mutex_lock(&root->lock);
+    if(isOwnedBy(root, sequence))
+    {
+        root->tag = SLOT_AVAILABLE;
+    }
+    pthread_mutex_unlock(&root->lock);
+}
+
+PriorityQueueResult cpqPopFirst(ConcurrentPriorityQueue queue, PQElement* element, PQElementPriority* priority)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    pthread_rwlock_rdlock(&queue->segment_lock);
+    pthread_mutex_lock(&queue->heap_lock);
+    if(queue->next == CPQ_ROOT)
+    {
+        pthread_mutex_unlock(&queue->heap_lock);
+        pthread_rwlock_unlock(&queue->segment_lock);
+        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    }
+    int bottom = --queue->next;
+    ConcurrentSlot* root = slotAt(queue, CPQ_ROOT);
+    ConcurrentSlot* bottom_slot = slotAt(queue, bottom);
+    pthread_mutex_lock(&root->lock);
+    if(bottom != CPQ_ROOT)
+    {
+        pthread_mutex_lock(&bottom_slot->lock);
+    }
+    pthread_mutex_unlock(&queue->heap_lock);
+    PQElement first_element = root->element;
+    PQElementPriority first_priority = root->priority;
+    root->tag = SLOT_EMPTY;
+    if(bottom == CPQ_ROOT)
+    {
+        pthread_mutex_unlock(&root->lock);
+    }
+    else
+    {
+        //the bottom element takes the root. If it was still being inserted, its insertion is over now
+        swapSlots(root, bottom_slot);
+        pthread_mutex_unlock(&bottom_slot->lock);
+        root->tag = SLOT_AVAILABLE;
+        siftDown(queue, root);
+    }
+    pthread_rwlock_unlock(&queue->segment_lock);
+    if(element != NULL)
+    {
+        *element = first_element;
+    }
+    else
+    {
+        queue->freeElementFunction(first_element);
+    }
+    if(priority != NULL)
+    {
+        *priority = first_priority;
+    }
+    else
+    {
+        queue->freeElementPriority(first_priority);
+    }
+    return PQ_SUCCESS;
+}
+
+static void siftDown(ConcurrentPriorityQueue queue, ConcurrentSlot* root)
+{
+    int parent = CPQ_ROOT;
+    ConcurrentSlot* parent_slot = root;
+    while(parent <= queue->capacity / 2)
+    {
+        int left = 2 * parent;
+        int right = left + 1;
+        ConcurrentSlot* left_slot = slotAt(queue, left);
+        ConcurrentSlot* right_slot = right <= queue->capacity ? slotAt(queue, right) : NULL;
+        pthread_mutex_lock(&left_slot->lock);
+        if(right_slot != NULL)
+        {
+            pthread_mutex_lock(&right_slot->lock);
+        }
+        if(left_slot->tag == SLOT_EMPTY)
+        {
+            if(right_slot != NULL)
+            {
+                pthread_mutex_unlock(&right_slot->lock);
+            }
+            pthread_mutex_unlock(&left_slot->lock);
+            break;
+        }
+        int child = left;
+        ConcurrentSlot* child_slot = left_slot;
+        if(right_slot != NULL && right_slot->tag != SLOT_EMPTY && slotBefore(queue, right_slot, left_slot))
+        {
+            pthread_mutex_unlock(&left_slot->lock);
+            child = right;
+            child_slot = right_slot;
+        }
+        else if(right_slot != NULL)
+        {
+            pthread_mutex_unlock(&right_slot->lock);
+        }
+        if(!slotBefore(queue, child_slot, parent_slot))
+        {
+            pthread_mutex_unlock(&child_slot->lock);
+            break;
+        }
+        //a busy child moves up with the swap, its insertion finds it again by its stamp
+        swapSlots(parent_slot, child_slot);
+        pthread_mutex_unlock(&parent_slot->lock);
+        parent = child;
+        parent_slot = child_slot;
+    }
+    pthread_mutex_unlock(&parent_slot->lock);
+}
@@ -0,0 +1,100 @@
+#ifndef PRIORITY_QUEUE_CONCURRENT_H
+#define PRIORITY_QUEUE_CONCURRENT_H
+
+#include "priority_queue.h"
+
+/**
+* Concurrent Priority Queue Container
+*
+* A priority queue that any number of threads may insert into and pop from at the same
+* time, with the same order as priority_queue.h: the highest priority first, and between
+* equal priorities the element inserted first. Every insertion and every pop takes effect
+* at once, at some moment between its call and its return, so a pop always returns the
+* first element of the queue at that moment.
+*
+* It is a binary heap with a lock per slot (Hunt et al.): an insertion climbs from the bottom
+* and a pop sinks from the root, each locking only the slots it is comparing, so threads
+* working on different parts of the heap do not wait for each other. A short global lock
+* only hands out slots. Copying and freeing elements and priorities is done outside of
+* all the locks.
+* There is no iterator and no way to look at an element without popping it: any element
+* another thread can see may be popped and freed by a third one at any time.
+*
+* The following functions are available:
+*   cpqCreate		    - Creates a new empty concurrent priority queue
+*   cpqDestroy		    - Deletes an existing concurrent priority queue and frees all resources
+*   cpqGetSize		    - Returns the number of elements in a concurrent priority queue
+*   cpqInsert	        - Insert an element with a given priority to the queue.
+*   cpqPopFirst         - Removes the highest priority element and hands it over to the caller
+*/
+
+/** Type for defining the concurrent priority queue */
+typedef struct ConcurrentPriorityQueue_t *ConcurrentPriorityQueue;
+
+/**
+* cpqCreate: Allocates a new empty concurrent priority queue.
+* The functions are called from the threads using the queue, possibly from several of them at once.
+*
+* @param copy_element - Function pointer to be used for copying data elements into the queue.
+* @param free_element - Function pointer to be used for freeing data elements.
+* @param copy_priority - Function pointer to be used for copying priorities into the queue.
+* @param free_priority - Function pointer to be used for freeing priorities.
+* @param compare_priorities - Function pointer to be used for comparing priorities.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new concurrent priority queue in case of success.
+*/
+ConcurrentPriorityQueue cpqCreate(CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities);
+
+/**
+* cpqDestroy: Deallocates an existing concurrent priority queue. Clears all elements by using the
+* free functions. No other thread may be using the queue.
+*
+* @param queue - Target queue to be deallocated. If queue is NULL nothing will be done
+*/
+void cpqDestroy(ConcurrentPriorityQueue queue);
+
+/**
+* cpqGetSize: Returns the number of elements in a concurrent priority queue, including the
+* ones that are being inserted at the moment.
+*
+* @param queue - The concurrent priority queue whose size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the queue.
+*/
+int cpqGetSize(ConcurrentPriorityQueue queue);
+
+/**
+*   cpqInsert: add a copy of an element with a specific priority.
+*
+* @param queue - The concurrent priority queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The priority to associate with the given element.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_OUT_OF_MEMORY if an allocation failed
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult cpqInsert(ConcurrentPriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/**
+*   cpqPopFirst: Removes the highest priority element from the queue without freeing it.
+*   If there are multiple elements with the same highest priority, the first inserted element is popped.
+*   The element and its priority are handed over to the caller, who becomes responsible for freeing them.
+*
+* @param queue - The concurrent priority queue to pop the element from.
+* @param element - Where to store the popped element. If NULL, the element is freed using the free function.
+* @param priority - Where to store the popped priority. If NULL, the priority is freed using the free function.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ELEMENT_DOES_NOT_EXISTS if the queue is empty.
+* 	PQ_SUCCESS the most prioritized element had been popped successfully.
+*/
+PriorityQueueResult cpqPopFirst(ConcurrentPriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+#endif /* PRIORITY_QUEUE_CONCURRENT_H */
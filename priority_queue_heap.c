@@ -0,0 +1,334 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "priority_queue_internal.h"
+
+/**
+* Heap engines: the nodes are kept in an array ordered as a d-ary heap, the highest
+* priority node at slot 0 and the children of slot i at slots d*i+1 to d*i+d. Every
+* node remembers its slot so it can be unlinked from the middle of the heap in O(log n).
+* The binary heap (d = 2) does the fewest comparisons. The 4-ary and 8-ary heaps are
+* half and a third as deep, so sifting down touches fewer cache lines in large heaps:
+* the array is placed so that the d children of a slot share one cache line, and the
+* comparisons between them do not load another one.
+* The heap does not keep a full order, iterating is done by the generic part over a
+* sorted snapshot.
+*/
+
+#define HEAP_INITIAL_CAPACITY 16
+#define HEAP_GROWTH_FACTOR 2
+#define HEAP_CACHE_LINE 64
+
+typedef struct HeapState_t
+{
+    Node* slots;
+    Node* storage; //the allocation slots lies in, slots is moved up in it to line the children up
+    int count;
+    int capacity;
+    int arity_shift; //log2 of the number of children of a slot
+}*HeapState;
+
+static bool binaryHeapInit(PriorityQueue queue);
+static bool fourAryHeapInit(PriorityQueue queue);
+static bool eightAryHeapInit(PriorityQueue queue);
+static void heapRelease(PriorityQueue queue);
+static bool heapInsert(PriorityQueue queue, Node node);
+static bool heapBuild(PriorityQueue queue, Node* nodes, int count);
+static void heapDetach(PriorityQueue queue, Node node);
+static Node heapFirst(PriorityQueue queue);
+static void heapVisitAll(PriorityQueue queue, NodeVisitor visit, void* context);
+static void heapReset(PriorityQueue queue);
+static bool heapReserve(PriorityQueue queue, int capacity);
+static void heapVisitChildren(PriorityQueue queue, Node node, NodeVisitor visit, void* context);
+
+//allocates the state of a heap whose slots have 1 << arity_shift children
+static bool heapInit(PriorityQueue queue, int arity_shift);
+
+//makes sure there is room for one more node
+static bool heapEnsureCapacity(HeapState state);
+
+//resizes the heap array to new_capacity slots
+static bool heapResize(HeapState state, int new_capacity);
+
+//places node at slot index and records the slot in the node
+static void heapPlace(HeapState state, Node node, int index);
+
+//moves the node at index up until its parent comes before it
+static void heapSiftUp(PriorityQueue queue, HeapState state, int index);
+
+//moves the node at index down until it comes before all of its children
+static void heapSiftDown(PriorityQueue queue, HeapState state, int index);
+
+const PQEngine pqBinaryHeapEngine = {
+    binaryHeapInit,
+    heapRelease,
+    heapInsert,
+    heapInsert,
+    heapDetach,
+    heapFirst,
+    NULL,
+    heapVisitAll,
+    heapReset,
+    heapReserve,
+    heapBuild,
+    NULL,
+    heapVisitChildren,
+    NULL
+};
+
+const PQEngine pqFourAryHeapEngine = {
+    fourAryHeapInit,
+    heapRelease,
+    heapInsert,
+    heapInsert,
+    heapDetach,
+    heapFirst,
+    NULL,
+    heapVisitAll,
+    heapReset,
+    heapReserve,
+    heapBuild,
+    NULL,
+    heapVisitChildren,
+    NULL
+};
+
+const PQEngine pqEightAryHeapEngine = {
+    eightAryHeapInit,
+    heapRelease,
+    heapInsert,
+    heapInsert,
+    heapDetach,
+    heapFirst,
+    NULL,
+    heapVisitAll,
+    heapReset,
+    heapReserve,
+    heapBuild,
+    NULL,
+    heapVisitChildren,
+    NULL
+};
+
+static bool binaryHeapInit(PriorityQueue queue)
+{
+    return heapInit(queue, 1);
+}
+
+static bool fourAryHeapInit(PriorityQueue queue)
+{
+    return heapInit(queue, 2);
+}
+
+static bool eightAryHeapInit(PriorityQueue queue)
+{
+    return heapInit(queue, 3);
+}
+
+static bool heapInit(PriorityQueue queue, int arity_shift)
+{
+    HeapState state = malloc(sizeof(*state));
+    if(state == NULL)
+    {
+        return false;
+    }
+    state->slots = NULL;
+    state->storage = NULL;
+    state->count = 0;
+    state->capacity = 0;
+    state->arity_shift = arity_shift;
+    queue->engine_state = state;
+    return true;
+}
+
+static void heapRelease(PriorityQueue queue)
+{
+    HeapState state = queue->engine_state;
+    free(state->storage);
+    free(state);
+    queue->engine_state = NULL;
+}
+
+static bool heapEnsureCapacity(HeapState state)
+{
+    if(state->count < state->capacity)
+    {
+        return true;
+    }
+    return heapResize(state, state->capacity == 0 ? HEAP_INITIAL_CAPACITY : state->capacity * HEAP_GROWTH_FACTOR);
+}
+
+static bool heapResize(HeapState state, int new_capacity)
+{
+    //a cache line more than needed, the slots start where slot 1, the first child of the root, starts a line.
+    //The children of every slot then start a line too: d*i+1 is 1 more than a multiple of d
+    Node* new_storage = malloc(sizeof(*new_storage) * new_capacity + HEAP_CACHE_LINE);
+    if(new_storage == NULL)
+    {
+        return false;
+    }
+    uintptr_t first_child = (uintptr_t) (new_storage + 1);
+    size_t shift = (HEAP_CACHE_LINE - first_child % HEAP_CACHE_LINE) % HEAP_CACHE_LINE;
+    Node* new_slots = new_storage + shift / sizeof(*new_storage);
+    if(state->count > 0)
+    {
+        memcpy(new_slots, state->slots, sizeof(*new_slots) * state->count);
+    }
+    free(state->storage);
+    state->storage = new_storage;
+    state->slots = new_slots;
+    state->capacity = new_capacity;
+    return true;
+}
+
+static bool heapReserve(PriorityQueue queue, int capacity)
+{
+    HeapState state = queue->engine_state;
+    return capacity <= state->capacity || heapResize(state, capacity);
+}
+
+static void heapPlace(HeapState state, Node node, int index)
+{
+    state->slots[index] = node;
+    node->index = index;
+}
+
+static void heapSiftUp(PriorityQueue queue, HeapState state, int index)
+{
+    Node node = state->slots[index];
+    while(index > 0)
+    {
+        int parent = (index - 1) >> state->arity_shift;
+        if(!pqNodeBefore(queue, node, state->slots[parent]))
+        {
+            break;
+        }
+        heapPlace(state, state->slots[parent], index);
+        index = parent;
+    }
+    heapPlace(state, node, index);
+}
+
+static void heapSiftDown(PriorityQueue queue, HeapState state, int index)
+{
+    Node node = state->slots[index];
+    while(true)
+    {
+        int first_child = (index << state->arity_shift) + 1;
+        if(first_child >= state->count)
+        {
+            break;
+        }
+        int end = first_child + (1 << state->arity_shift);
+        end = end < state->count ? end : state->count;
+        int child = first_child;
+        for(int sibling = first_child + 1; sibling < end; sibling++)
+        {
+            if(pqNodeBefore(queue, state->slots[sibling], state->slots[child]))
+            {
+                child = sibling;
+            }
+        }
+        if(!pqNodeBefore(queue, state->slots[child], node))
+        {
+            break;
+        }
+        heapPlace(state, state->slots[child], index);
+        index = child;
+    }
+    heapPlace(state, node, index);
+}
+
+static bool heapInsert(PriorityQueue queue, Node node)
+{
+    HeapState state = queue->engine_state;
+    if(!heapEnsureCapacity(state))
+    {
+        return false;
+    }
+    heapPlace(state, node, state->count);
+    state->count++;
+    heapSiftUp(queue, state, node->index);
+    return true;
+}
+
+static bool heapBuild(PriorityQueue queue, Node* nodes, int count)
+{
+    HeapState state = queue->engine_state;
+    if(!heapReserve(queue, state->count + count))
+    {
+        return false;
+    }
+    int old_count = state->count;
+    for(int i = 0; i < count; i++)
+    {
+        heapPlace(state, nodes[i], state->count++);
+    }
+    if(count < old_count)
+    {
+        //a small batch next to a large heap: sifting each new node up is cheaper than rebuilding
+        for(int i = old_count; i < state->count; i++)
+        {
+            heapSiftUp(queue, state, i);
+        }
+        return true;
+    }
+    //Floyd's construction, every parent from the last one up to the root is sifted down once
+    int last_parent = state->count > 1 ? (state->count - 2) >> state->arity_shift : -1;
+    for(int i = last_parent; i >= 0; i--)
+    {
+        heapSiftDown(queue, state, i);
+    }
+    return true;
+}
+
+static void heapDetach(PriorityQueue queue, Node node)
+{
+    HeapState state = queue->engine_state;
+    int index = node->index;
+    assert(index >= 0 && index < state->count && state->slots[index] == node);
+    state->count--;
+    node->index = -1;
+    if(index == state->count)
+    {
+        return;
+    }
+    //the last node takes the freed slot and moves to wherever it belongs from there
+    Node moved = state->slots[state->count];
+    heapPlace(state, moved, index);
+    heapSiftDown(queue, state, index);
+    heapSiftUp(queue, state, moved->index);
+}
+
+static Node heapFirst(PriorityQueue queue)
+{
+    HeapState state = queue->engine_state;
+    return state->count > 0 ? state->slots[0] : NULL;
+}
+
+static void heapVisitAll(PriorityQueue queue, NodeVisitor visit, void* context)
+{
+    HeapState state = queue->engine_state;
+    for(int i = 0; i < state->count; i++)
+    {
+        visit(queue, state->slots[i], context);
+    }
+}
+
+static void heapVisitChildren(PriorityQueue queue, Node node, NodeVisitor visit, void* context)
+{
+    HeapState state = queue->engine_state;
+    int first_child = (node->index << state->arity_shift) + 1;
+    int end = first_child + (1 << state->arity_shift);
+    for(int child = first_child; child < end && child < state->count; child++)
+    {
+        visit(queue, state->slots[child], context);
+    }
+}
+
+static void heapReset(PriorityQueue queue)
+{
+    HeapState state = queue->engine_state;
+    state->count = 0;
+}
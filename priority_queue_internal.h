@@ -0,0 +1,176 @@
+#ifndef PRIORITY_QUEUE_INTERNAL_H
+#define PRIORITY_QUEUE_INTERNAL_H
+
+#include <limits.h>
+#include "priority_queue.h"
+
+/**
+* Priority Queue internals
+*
+* Shared between the generic part of the container (priority_queue.c) and the
+* storage engines that keep the nodes in order (priority_queue_list.c,
+* priority_queue_heap.c, priority_queue_pairing.c, priority_queue_minmax.c,
+* priority_queue_skiplist.c, priority_queue_radix.c, priority_queue_calendar.c).
+* Nothing here is part of the public interface.
+*
+* The generic part owns the nodes: it copies and frees elements and priorities,
+* counts the elements and drives the internal iterator. An engine only links
+* and unlinks nodes it is handed, and reports which node comes first.
+* Lazily removed nodes stay linked in the engine, which does not tell them apart
+* from the others. The generic part skips them.
+*/
+
+typedef struct PQNode_t
+{
+    PQElement element;
+    PQElementPriority element_priority;
+    unsigned long sequence; //insertion stamp, the tie-breaker between equal priorities
+    struct PQNode_t* next;  //list engine: the next node in priority order. Pairing heap: the next sibling.
+                            //Radix heap and calendar queue: the next node in the same bucket
+    struct PQNode_t* prev;  //list engine: the previous node in priority order. Pairing heap: the previous sibling.
+                            //Radix heap and calendar queue: the previous node in the same bucket
+    struct PQNode_t* child; //pairing heap engine: the first child
+    struct PQNode_t* parent;//pairing heap engine: the parent, NULL for the root
+    int index;              //heap engines: the slot of the node in the heap array. Skiplist engine: the levels it is on.
+                            //Radix heap and calendar queue engines: the bucket it is in
+    int rank;               //position of the node in the ordered snapshot
+    unsigned long hash;     //hash of the element, when the queue keeps a hash index
+    struct PQNode_t* hash_next; //the next node in the same hash index bucket
+    struct PQNode_t** forward; //skiplist engine: the next node on every level above the lowest one
+    bool removed;           //removed lazily: still linked, but skipped until it is unlinked
+}*Node;
+
+//Called for every node an engine holds, in no particular order
+typedef void (*NodeVisitor)(PriorityQueue queue, Node node, void* context);
+
+typedef struct PQEngine_t
+{
+    //allocates the engine's state into queue->engine_state
+    bool (*init)(PriorityQueue queue);
+    //frees the engine's state. The nodes must have been taken care of before
+    void (*release)(PriorityQueue queue);
+    //links a node into the order. Returns false if an allocation failed
+    bool (*insert)(PriorityQueue queue, Node node);
+    //links a node that comes after every node already linked
+    bool (*append)(PriorityQueue queue, Node node);
+    //unlinks a node that is currently linked
+    void (*detach)(PriorityQueue queue, Node node);
+    //returns the highest priority node, NULL if there are none
+    Node (*first)(PriorityQueue queue);
+    //returns the node following node in priority order. NULL for engines that do not
+    //keep a full order, the generic part then iterates over a sorted snapshot
+    Node (*successor)(PriorityQueue queue, Node node);
+    //calls visit for every linked node. visit may free the node it is given
+    void (*visitAll)(PriorityQueue queue, NodeVisitor visit, void* context);
+    //forgets all the nodes without touching them
+    void (*reset)(PriorityQueue queue);
+    //makes room for capacity nodes. NULL for engines that need no room of their own
+    bool (*reserve)(PriorityQueue queue, int capacity);
+    //links count stamped nodes at once. Either links all of them or returns false and links none.
+    //NULL for engines that link them one by one
+    bool (*build)(PriorityQueue queue, Node* nodes, int count);
+    //moves every node of other, a queue of the same engine, into queue and leaves other empty.
+    //The nodes are already stamped. NULL for engines that link other's nodes with build instead
+    void (*meld)(PriorityQueue queue, PriorityQueue other);
+    //calls visit for every child of node in the engine's tree, all of them come after node. Must not change
+    //anything. NULL for engines that are not a tree with first at its root
+    void (*visitChildren)(PriorityQueue queue, Node node, NodeVisitor visit, void* context);
+    //returns the lowest priority node, NULL if there are none. NULL for engines that do not know it,
+    //the generic part then looks at every node
+    Node (*last)(PriorityQueue queue);
+} PQEngine;
+
+//Unit of node storage, aligned for a node and for any element or priority kept inline after it
+typedef union NodeStorage_t
+{
+    long double floating;
+    long long integer;
+    void* pointer;
+    void (*function)(void);
+} NodeStorage;
+
+//A block of nodes allocated at once. Nodes that are not in use wait on the queue's free list.
+//Every node takes queue->node_units storage units, so inline copies sit right after their node
+typedef struct NodeChunk_t
+{
+    struct NodeChunk_t* next;
+    int capacity;
+    NodeStorage storage[];
+} *NodeChunk;
+
+struct PriorityQueue_t
+{
+    int size; //linked nodes, the lazily removed ones included
+    PQBackend backend;
+    const PQEngine* engine;
+    void* engine_state;
+    unsigned long next_sequence;
+    int bound; //the most elements the queue keeps, the lowest ones are dropped beyond it. 0 for no bound
+    int removed_count;       //lazily removed nodes that are still linked
+    double removed_fraction; //the share of removed nodes that triggers a compaction. 0 removes eagerly
+    Node iterator_current_position;
+
+    //nodes sorted by priority, built on demand for engines without successor
+    //nodes removed through a cursor leave a NULL behind, the rest of the order still holds
+    Node* ordered_snapshot;
+    int snapshot_count;
+    int snapshot_capacity;
+    bool snapshot_valid;
+
+    //node allocator: every node of the queue lives in one of its chunks
+    NodeChunk node_chunks;
+    Node free_nodes;
+    int free_node_count;
+    int node_capacity;
+    int node_units;
+
+    //inline queues copy elements and priorities into their nodes, both sizes are 0 otherwise
+    size_t element_size;
+    size_t priority_size;
+
+    //optional index from element hash to nodes, NULL buckets when the queue has no hash function
+    Node* hash_buckets;
+    int hash_capacity;
+
+    CopyPQElement copyElementFunction;
+    FreePQElement freeElementFunction;
+    EqualPQElements isEqualElementFunction;
+    CopyPQElementPriority copyPriorityFunction;
+    FreePQElementPriority freeElementPriority;
+    ComparePQElementPriorities comparePrioritiesFunction;
+    HashPQElement hashElementFunction;
+    PQPriorityKey priorityKeyFunction; //NULL unless the queue was made by pqCreateKeyed
+};
+
+extern const PQEngine pqListEngine;
+extern const PQEngine pqBinaryHeapEngine;
+extern const PQEngine pqFourAryHeapEngine;
+extern const PQEngine pqEightAryHeapEngine;
+extern const PQEngine pqPairingHeapEngine;
+extern const PQEngine pqMinMaxHeapEngine;
+extern const PQEngine pqSkiplistEngine;
+extern const PQEngine pqRadixHeapEngine;
+extern const PQEngine pqCalendarQueueEngine;
+
+//merge sorts nodes by the queue's order, buffer must have room for count nodes
+void pqSortNodes(PriorityQueue queue, Node* nodes, Node* buffer, int count);
+
+//returns whether node a is ordered before node b: higher priority first, earlier insertion on ties
+static inline bool pqNodeBefore(PriorityQueue queue, Node a, Node b)
+{
+    int delta = queue->comparePrioritiesFunction(a->element_priority, b->element_priority);
+    if(delta != 0)
+    {
+        return delta > 0;
+    }
+    return a->sequence < b->sequence;
+}
+
+//returns the key of node's priority for queues made by pqCreateKeyed. The sign bit is flipped so the keys
+//are ordered as unsigned numbers the way they are ordered as signed ones
+static inline unsigned long pqNodeKey(PriorityQueue queue, Node node)
+{
+    return (unsigned long) queue->priorityKeyFunction(node->element_priority) ^ ~(ULONG_MAX >> 1);
+}
+
+#endif /* PRIORITY_QUEUE_INTERNAL_H */
@@ -0,0 +1,250 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "priority_queue_internal.h"
+
+/**
+* List engine: the nodes are kept in a doubly linked list sorted by priority.
+* Inserting walks the list to the node's slot, unlinking any node and advancing
+* an iterator are O(1).
+* Inserting starts from the tail when the node belongs there, and otherwise from the
+* last insertion point (the finger), so monotone input is appended in O(1) and nearly
+* sorted input only walks a few nodes.
+*/
+
+typedef struct ListState_t
+{
+    Node head;
+    Node tail;
+    Node finger; //where the last insertion happened, a search starts there
+}*ListState;
+
+static bool listInit(PriorityQueue queue);
+static void listRelease(PriorityQueue queue);
+static bool listInsert(PriorityQueue queue, Node node);
+static bool listAppend(PriorityQueue queue, Node node);
+static void listDetach(PriorityQueue queue, Node node);
+static bool listBuild(PriorityQueue queue, Node* nodes, int count);
+static void listMeld(PriorityQueue queue, PriorityQueue other);
+static Node listLast(PriorityQueue queue);
+static Node listFirst(PriorityQueue queue);
+static Node listSuccessor(PriorityQueue queue, Node node);
+static void listVisitAll(PriorityQueue queue, NodeVisitor visit, void* context);
+static void listReset(PriorityQueue queue);
+
+//links node right after previous, or at the head if previous is NULL
+static void listLinkAfter(ListState state, Node previous, Node node);
+
+//merges a sorted chain of nodes, linked through next, into the list in one pass
+static void listMergeChain(PriorityQueue queue, ListState state, Node chain);
+
+//returns the node that node should be linked after, searching from start in either direction
+static Node listFindSlotFrom(PriorityQueue queue, Node start, Node node);
+
+const PQEngine pqListEngine = {
+    listInit,
+    listRelease,
+    listInsert,
+    listAppend,
+    listDetach,
+    listFirst,
+    listSuccessor,
+    listVisitAll,
+    listReset,
+    NULL,
+    listBuild,
+    listMeld,
+    NULL,
+    listLast
+};
+
+static bool listInit(PriorityQueue queue)
+{
+    ListState state = malloc(sizeof(*state));
+    if(state == NULL)
+    {
+        return false;
+    }
+    state->head = NULL;
+    state->tail = NULL;
+    state->finger = NULL;
+    queue->engine_state = state;
+    return true;
+}
+
+static void listRelease(PriorityQueue queue)
+{
+    free(queue->engine_state);
+    queue->engine_state = NULL;
+}
+
+static bool listInsert(PriorityQueue queue, Node node)
+{
+    ListState state = queue->engine_state;
+    Node previous;
+    if(state->tail == NULL || !pqNodeBefore(queue, node, state->tail))
+    {
+        previous = state->tail;
+    }
+    else
+    {
+        previous = listFindSlotFrom(queue, state->finger != NULL ? state->finger : state->head, node);
+    }
+    listLinkAfter(state, previous, node);
+    state->finger = node;
+    return true;
+}
+
+static Node listFindSlotFrom(PriorityQueue queue, Node start, Node node)
+{
+    Node current = start;
+    if(pqNodeBefore(queue, node, current))
+    {
+        while(current != NULL && pqNodeBefore(queue, node, current))
+        {
+            current = current->prev;
+        }
+        return current;
+    }
+    while(current->next != NULL && !pqNodeBefore(queue, node, current->next))
+    {
+        current = current->next;
+    }
+    return current;
+}
+
+static bool listAppend(PriorityQueue queue, Node node)
+{
+    ListState state = queue->engine_state;
+    assert(state->tail == NULL || pqNodeBefore(queue, state->tail, node));
+    listLinkAfter(state, state->tail, node);
+    return true;
+}
+
+static bool listBuild(PriorityQueue queue, Node* nodes, int count)
+{
+    ListState state = queue->engine_state;
+    Node* buffer = malloc(sizeof(*buffer) * count);
+    if(buffer == NULL)
+    {
+        return false;
+    }
+    pqSortNodes(queue, nodes, buffer, count);
+    free(buffer);
+    for(int i = 0; i < count; i++)
+    {
+        nodes[i]->next = i + 1 < count ? nodes[i + 1] : NULL;
+    }
+    listMergeChain(queue, state, nodes[0]);
+    return true;
+}
+
+static void listMeld(PriorityQueue queue, PriorityQueue other)
+{
+    ListState other_state = other->engine_state;
+    listMergeChain(queue, queue->engine_state, other_state->head);
+    listReset(other);
+}
+
+static void listMergeChain(PriorityQueue queue, ListState state, Node chain)
+{
+    Node previous = NULL;
+    Node current = state->head;
+    while(chain != NULL)
+    {
+        Node incoming = chain;
+        chain = chain->next;
+        while(current != NULL && !pqNodeBefore(queue, incoming, current))
+        {
+            previous = current;
+            current = current->next;
+        }
+        listLinkAfter(state, previous, incoming);
+        previous = incoming;
+    }
+}
+
+static void listLinkAfter(ListState state, Node previous, Node node)
+{
+    node->prev = previous;
+    node->next = previous == NULL ? state->head : previous->next;
+    if(previous == NULL)
+    {
+        state->head = node;
+    }
+    else
+    {
+        previous->next = node;
+    }
+    if(node->next == NULL)
+    {
+        state->tail = node;
+    }
+    else
+    {
+        node->next->prev = node;
+    }
+}
+
+static void listDetach(PriorityQueue queue, Node node)
+{
+    ListState state = queue->engine_state;
+    if(state->finger == node)
+    {
+        state->finger = node->prev;
+    }
+    if(node->prev == NULL)
+    {
+        state->head = node->next;
+    }
+    else
+    {
+        node->prev->next = node->next;
+    }
+    if(node->next == NULL)
+    {
+        state->tail = node->prev;
+    }
+    else
+    {
+        node->next->prev = node->prev;
+    }
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+static Node listFirst(PriorityQueue queue)
+{
+    ListState state = queue->engine_state;
+    return state->head;
+}
+
+static Node listLast(PriorityQueue queue)
+{
+    ListState state = queue->engine_state;
+    return state->tail;
+}
+
+static Node listSuccessor(PriorityQueue queue, Node node)
+{
+    return node->next;
+}
+
+static void listVisitAll(PriorityQueue queue, NodeVisitor visit, void* context)
+{
+    ListState state = queue->engine_state;
+    Node current = state->head;
+    while(current)
+    {
+        Node next = current->next;//visit may free current
+        visit(queue, current, context);
+        current = next;
+    }
+}
+
+static void listReset(PriorityQueue queue)
+{
+    ListState state = queue->engine_state;
+    state->head = NULL;
+    state->tail = NULL;
+    state->finger = NULL;
+}
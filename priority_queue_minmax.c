@@ -0,0 +1,295 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "priority_queue_internal.h"
+
+/**
+* Min-max heap engine: the nodes are kept in an array ordered as a min-max heap. On
+* the even levels of the tree (the root's level included) every node comes before all
+* of its descendants, on the odd levels every node comes after all of its descendants.
+* So the first node is at the root and the last node is one of the root's children,
+* both are found in O(1) and unlinking any node is O(log n).
+* The heap does not keep a full order, iterating is done by the generic part over a
+* sorted snapshot.
+*/
+
+#define MINMAX_INITIAL_CAPACITY 16
+#define MINMAX_GROWTH_FACTOR 2
+
+typedef struct MinMaxState_t
+{
+    Node* slots;
+    int count;
+    int capacity;
+}*MinMaxState;
+
+static bool minmaxInit(PriorityQueue queue);
+static void minmaxRelease(PriorityQueue queue);
+static bool minmaxInsert(PriorityQueue queue, Node node);
+static void minmaxDetach(PriorityQueue queue, Node node);
+static Node minmaxFirst(PriorityQueue queue);
+static void minmaxVisitAll(PriorityQueue queue, NodeVisitor visit, void* context);
+static void minmaxReset(PriorityQueue queue);
+static bool minmaxReserve(PriorityQueue queue, int capacity);
+static bool minmaxBuild(PriorityQueue queue, Node* nodes, int count);
+static Node minmaxLast(PriorityQueue queue);
+
+//resizes the heap array to new_capacity slots
+static bool minmaxResize(MinMaxState state, int new_capacity);
+
+//places node at slot index and records the slot in the node
+static void minmaxPlace(MinMaxState state, Node node, int index);
+
+//swaps the nodes at two slots
+static void minmaxSwap(MinMaxState state, int a, int b);
+
+//returns whether the slot is on an even level, where nodes come before their descendants
+static bool minmaxIsFirstLevel(int index);
+
+//returns whether a belongs closer to the root than b on a level of the given kind: before b on an
+//even level, after b on an odd level
+static bool minmaxOutranks(PriorityQueue queue, Node a, Node b, bool first_level);
+
+//moves the node at index up, over the levels of its kind, until its grandparent outranks it
+static void minmaxBubbleUp(PriorityQueue queue, MinMaxState state, int index, bool first_level);
+
+//moves the node at index up to where it belongs among its ancestors
+static void minmaxPushUp(PriorityQueue queue, MinMaxState state, int index);
+
+//moves the node at index down to where it belongs among its descendants
+static void minmaxTrickleDown(PriorityQueue queue, MinMaxState state, int index);
+
+const PQEngine pqMinMaxHeapEngine = {
+    minmaxInit,
+    minmaxRelease,
+    minmaxInsert,
+    minmaxInsert,
+    minmaxDetach,
+    minmaxFirst,
+    NULL,
+    minmaxVisitAll,
+    minmaxReset,
+    minmaxReserve,
+    minmaxBuild,
+    NULL,
+    NULL,
+    minmaxLast
+};
+
+static bool minmaxInit(PriorityQueue queue)
+{
+    MinMaxState state = malloc(sizeof(*state));
+    if(state == NULL)
+    {
+        return false;
+    }
+    state->slots = NULL;
+    state->count = 0;
+    state->capacity = 0;
+    queue->engine_state = state;
+    return true;
+}
+
+static void minmaxRelease(PriorityQueue queue)
+{
+    MinMaxState state = queue->engine_state;
+    free(state->slots);
+    free(state);
+    queue->engine_state = NULL;
+}
+
+static bool minmaxResize(MinMaxState state, int new_capacity)
+{
+    Node* new_slots = realloc(state->slots, sizeof(*new_slots) * new_capacity);
+    if(new_slots == NULL)
+    {
+        return false;
+    }
+    state->slots = new_slots;
+    state->capacity = new_capacity;
+    return true;
+}
+
+static bool minmaxReserve(PriorityQueue queue, int capacity)
+{
+    MinMaxState state = queue->engine_state;
+    return capacity <= state->capacity || minmaxResize(state, capacity);
+}
+
+static void minmaxPlace(MinMaxState state, Node node, int index)
+{
+    state->slots[index] = node;
+    node->index = index;
+}
+
+static void minmaxSwap(MinMaxState state, int a, int b)
+{
+    Node node = state->slots[a];
+    minmaxPlace(state, state->slots[b], a);
+    minmaxPlace(state, node, b);
+}
+
+static bool minmaxIsFirstLevel(int index)
+{
+    int level = 0;
+    for(int position = index + 1; position > 1; position /= 2)
+    {
+        level++;
+    }
+    return level % 2 == 0;
+}
+
+static bool minmaxOutranks(PriorityQueue queue, Node a, Node b, bool first_level)
+{
+    return first_level ? pqNodeBefore(queue, a, b) : pqNodeBefore(queue, b, a);
+}
+
+static void minmaxBubbleUp(PriorityQueue queue, MinMaxState state, int index, bool first_level)
+{
+    while(index > 2)
+    {
+        int grandparent = ((index - 1) / 2 - 1) / 2;
+        if(!minmaxOutranks(queue, state->slots[index], state->slots[grandparent], first_level))
+        {
+            break;
+        }
+        minmaxSwap(state, index, grandparent);
+        index = grandparent;
+    }
+}
+
+static void minmaxPushUp(PriorityQueue queue, MinMaxState state, int index)
+{
+    if(index == 0)
+    {
+        return;
+    }
+    bool first_level = minmaxIsFirstLevel(index);
+    int parent = (index - 1) / 2;
+    //a node that outranks its parent on the parent's own terms moves to the parent's kind of levels
+    if(minmaxOutranks(queue, state->slots[index], state->slots[parent], !first_level))
+    {
+        minmaxSwap(state, index, parent);
+        minmaxBubbleUp(queue, state, parent, !first_level);
+    }
+    else
+    {
+        minmaxBubbleUp(queue, state, index, first_level);
+    }
+}
+
+static void minmaxTrickleDown(PriorityQueue queue, MinMaxState state, int index)
+{
+    bool first_level = minmaxIsFirstLevel(index);
+    while(true)
+    {
+        //the node that outranks the others among the children and the grandchildren
+        int best = -1;
+        int descendants[] = {2 * index + 1, 2 * index + 2, 4 * index + 3, 4 * index + 4, 4 * index + 5, 4 * index + 6};
+        for(int i = 0; i < (int) (sizeof(descendants) / sizeof(*descendants)); i++)
+        {
+            int candidate = descendants[i];
+            if(candidate < state->count &&
+               (best < 0 || minmaxOutranks(queue, state->slots[candidate], state->slots[best], first_level)))
+            {
+                best = candidate;
+            }
+        }
+        if(best < 0 || !minmaxOutranks(queue, state->slots[best], state->slots[index], first_level))
+        {
+            return;
+        }
+        minmaxSwap(state, index, best);
+        if(best <= 2 * index + 2)
+        {
+            return; //a child has no descendants of the same kind below the node
+        }
+        int parent = (best - 1) / 2;
+        if(minmaxOutranks(queue, state->slots[best], state->slots[parent], !first_level))
+        {
+            minmaxSwap(state, best, parent);
+        }
+        index = best;
+    }
+}
+
+static bool minmaxInsert(PriorityQueue queue, Node node)
+{
+    MinMaxState state = queue->engine_state;
+    if(state->count == state->capacity &&
+       !minmaxResize(state, state->capacity == 0 ? MINMAX_INITIAL_CAPACITY : state->capacity * MINMAX_GROWTH_FACTOR))
+    {
+        return false;
+    }
+    minmaxPlace(state, node, state->count);
+    state->count++;
+    minmaxPushUp(queue, state, node->index);
+    return true;
+}
+
+static bool minmaxBuild(PriorityQueue queue, Node* nodes, int count)
+{
+    MinMaxState state = queue->engine_state;
+    if(!minmaxReserve(queue, state->count + count))
+    {
+        return false;
+    }
+    for(int i = 0; i < count; i++)
+    {
+        minmaxPlace(state, nodes[i], state->count++);
+    }
+    //bottom up, as Floyd's construction of a binary heap
+    for(int i = state->count / 2 - 1; i >= 0; i--)
+    {
+        minmaxTrickleDown(queue, state, i);
+    }
+    return true;
+}
+
+static void minmaxDetach(PriorityQueue queue, Node node)
+{
+    MinMaxState state = queue->engine_state;
+    int index = node->index;
+    assert(index >= 0 && index < state->count && state->slots[index] == node);
+    state->count--;
+    node->index = -1;
+    if(index == state->count)
+    {
+        return;
+    }
+    //the last slot's node takes the freed slot and moves to wherever it belongs from there
+    Node moved = state->slots[state->count];
+    minmaxPlace(state, moved, index);
+    minmaxTrickleDown(queue, state, index);
+    minmaxPushUp(queue, state, moved->index);
+}
+
+static Node minmaxFirst(PriorityQueue queue)
+{
+    MinMaxState state = queue->engine_state;
+    return state->count > 0 ? state->slots[0] : NULL;
+}
+
+static Node minmaxLast(PriorityQueue queue)
+{
+    MinMaxState state = queue->engine_state;
+    if(state->count <= 2)
+    {
+        return state->count == 0 ? NULL : state->slots[state->count - 1];
+    }
+    return pqNodeBefore(queue, state->slots[1], state->slots[2]) ? state->slots[2] : state->slots[1];
+}
+
+static void minmaxVisitAll(PriorityQueue queue, NodeVisitor visit, void* context)
+{
+    MinMaxState state = queue->engine_state;
+    for(int i = 0; i < state->count; i++)
+    {
+        visit(queue, state->slots[i], context);
+    }
+}
+
+static void minmaxReset(PriorityQueue queue)
+{
+    MinMaxState state = queue->engine_state;
+    state->count = 0;
+}
@@ -0,0 +1,287 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "priority_queue_multi.h"
+
+/**
+* Every internal queue is a binary heap PriorityQueue next to its own lock. The locks are
+* first only tried, so a thread that finds a queue in use moves on to another random queue
+* instead of waiting, and holding two of them at once can not deadlock. After MPQ_ATTEMPTS
+* tries an insertion waits for the lock of its last queue, and a pop waits for the lock of
+* every queue in turn, one at a time, looking for an element.
+* Copying and freeing elements and priorities is done outside of the locks.
+*/
+
+#define MPQ_ATTEMPTS 8
+
+typedef struct MultiPart_t
+{
+    pthread_mutex_t lock;
+    PriorityQueue queue;
+} MultiPart;
+
+struct MultiPriorityQueue_t
+{
+    MultiPart* parts;
+    int part_count;
+    CopyPQElement copyElementFunction;
+    FreePQElement freeElementFunction;
+    CopyPQElementPriority copyPriorityFunction;
+    FreePQElementPriority freeElementPriority;
+    ComparePQElementPriorities comparePrioritiesFunction;
+};
+
+//state of the random choices of each thread, so the threads do not share it. The state is kept in
+//the value of the key itself, so a thread has nothing to free when it exits
+static pthread_key_t random_state_key;
+static pthread_once_t random_state_once = PTHREAD_ONCE_INIT;
+static bool random_state_ready = false;
+
+//creates random_state_key, once for all the queues
+static void createRandomStateKey(void);
+
+//returns a random internal queue
+static MultiPart* randomPart(MultiPriorityQueue queue);
+
+//returns the locked part whose first element comes first, NULL if both of them are empty
+static MultiPart* betterPart(MultiPriorityQueue queue, MultiPart* a, MultiPart* b);
+
+//pops the first element of a locked part into element and priority. Returns false if it is empty
+static bool popPart(MultiPart* part, PQElement* element, PQElementPriority* priority);
+
+//frees the given members of all the parts from the first count, and the parts array
+static void destroyParts(MultiPriorityQueue queue, int count);
+
+static void createRandomStateKey(void)
+{
+    random_state_ready = pthread_key_create(&random_state_key, NULL) == 0;
+}
+
+static MultiPart* randomPart(MultiPriorityQueue queue)
+{
+    unsigned random_state = (unsigned) (uintptr_t) pthread_getspecific(random_state_key);
+    if(random_state == 0)
+    {
+        //every thread has its own stack, the address of a local tells the threads apart
+        random_state = (unsigned) (uintptr_t) &random_state | 1;
+    }
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    //the state is never 0 again, so failing to keep it only repeats the seed of this thread
+    pthread_setspecific(random_state_key, (void*) (uintptr_t) random_state);
+    return &queue->parts[random_state % (unsigned) queue->part_count];
+}
+
+static MultiPart* betterPart(MultiPriorityQueue queue, MultiPart* a, MultiPart* b)
+{
+    PQElement element = NULL;
+    PQElementPriority a_priority = NULL;
+    PQElementPriority b_priority = NULL;
+    bool a_empty = pqPeekTopK(a->queue, 1, &element, &a_priority) == 0;
+    bool b_empty = pqPeekTopK(b->queue, 1, &element, &b_priority) == 0;
+    if(a_empty || b_empty)
+    {
+        return a_empty ? (b_empty ? NULL : b) : a;
+    }
+    return queue->comparePrioritiesFunction(b_priority, a_priority) > 0 ? b : a;
+}
+
+static bool popPart(MultiPart* part, PQElement* element, PQElementPriority* priority)
+{
+    return pqPopFirst(part->queue, element, priority) == PQ_SUCCESS;
+}
+
+static void destroyParts(MultiPriorityQueue queue, int count)
+{
+    for(int i = 0; i < count; i++)
+    {
+        pqDestroy(queue->parts[i].queue);
+        pthread_mutex_destroy(&queue->parts[i].lock);
+    }
+    free(queue->parts);
+}
+
+MultiPriorityQueue mpqCreate(int queue_count,
+                             CopyPQElement copy_element,
+                             FreePQElement free_element,
+                             CopyPQElementPriority copy_priority,
+                             FreePQElementPriority free_priority,
+                             ComparePQElementPriorities compare_priorities)
+{
+    if(queue_count <= 0 || copy_element == NULL || free_element == NULL || copy_priority == NULL ||
+       free_priority == NULL || compare_priorities == NULL)
+    {
+        return NULL;
+    }
+    if(pthread_once(&random_state_once, createRandomStateKey) != 0 || !random_state_ready)
+    {
+        return NULL;
+    }
+    MultiPriorityQueue queue = malloc(sizeof(*queue));
+    if(queue == NULL)
+    {
+        return NULL;
+    }
+    queue->parts = malloc(sizeof(*queue->parts) * queue_count);
+    if(queue->parts == NULL)
+    {
+        free(queue);
+        return NULL;
+    }
+    for(int i = 0; i < queue_count; i++)
+    {
+        MultiPart* part = &queue->parts[i];
+        part->queue = pqCreateWithBackend(PQ_BACKEND_BINARY_HEAP, copy_element, free_element, NULL,
+                                          copy_priority, free_priority, compare_priorities);
+        if(part->queue == NULL || pthread_mutex_init(&part->lock, NULL) != 0)
+        {
+            pqDestroy(part->queue);
+            destroyParts(queue, i);
+            free(queue);
+            return NULL;
+        }
+    }
+    queue->part_count = queue_count;
+    queue->copyElementFunction = copy_element;
+    queue->freeElementFunction = free_element;
+    queue->copyPriorityFunction = copy_priority;
+    queue->freeElementPriority = free_priority;
+    queue->comparePrioritiesFunction = compare_priorities;
+    return queue;
+}
+
+void mpqDestroy(MultiPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return;
+    }
+    destroyParts(queue, queue->part_count);
+    free(queue);
+}
+
+int mpqGetSize(MultiPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return -1;
+    }
+    int size = 0;
+    for(int i = 0; i < queue->part_count; i++)
+    {
+        pthread_mutex_lock(&queue->parts[i].lock);
+        size += pqGetSize(queue->parts[i].queue);
+        pthread_mutex_unlock(&queue->parts[i].lock);
+    }
+    return size;
+}
+
+PriorityQueueResult mpqInsert(MultiPriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+    if(queue == NULL || element == NULL || priority == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    PQElement element_copy = queue->copyElementFunction(element);
+    if(element_copy == NULL)
+    {
+        return PQ_OUT_OF_MEMORY;
+    }
+    PQElementPriority priority_copy = queue->copyPriorityFunction(priority);
+    if(priority_copy == NULL)
+    {
+        queue->freeElementFunction(element_copy);
+        return PQ_OUT_OF_MEMORY;
+    }
+    MultiPart* part = randomPart(queue);
+    int attempt = 1;
+    while(pthread_mutex_trylock(&part->lock) != 0)
+    {
+        if(++attempt == MPQ_ATTEMPTS)
+        {
+            pthread_mutex_lock(&part->lock);
+            break;
+        }
+        part = randomPart(queue);
+    }
+    PriorityQueueResult result = pqInsertNoCopy(part->queue, element_copy, priority_copy, NULL);
+    pthread_mutex_unlock(&part->lock);
+    if(result != PQ_SUCCESS)
+    {
+        queue->freeElementFunction(element_copy);
+        queue->freeElementPriority(priority_copy);
+    }
+    return result;
+}
+
+PriorityQueueResult mpqRemove(MultiPriorityQueue queue)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    mpqPopFirst(queue, NULL, NULL);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult mpqPopFirst(MultiPriorityQueue queue, PQElement* element, PQElementPriority* priority)
+{
+    if(queue == NULL)
+    {
+        return PQ_NULL_ARGUMENT;
+    }
+    PQElement first_element = NULL;
+    PQElementPriority first_priority = NULL;
+    bool popped = false;
+    for(int attempt = 0; !popped && attempt < MPQ_ATTEMPTS; attempt++)
+    {
+        MultiPart* a = randomPart(queue);
+        MultiPart* b = randomPart(queue);
+        if(pthread_mutex_trylock(&a->lock) != 0)
+        {
+            continue;
+        }
+        if(b != a && pthread_mutex_trylock(&b->lock) != 0)
+        {
+            pthread_mutex_unlock(&a->lock);
+            continue;
+        }
+        MultiPart* better = betterPart(queue, a, b);
+        popped = better != NULL && popPart(better, &first_element, &first_priority);
+        if(b != a)
+        {
+            pthread_mutex_unlock(&b->lock);
+        }
+        pthread_mutex_unlock(&a->lock);
+    }
+    //the queues picked were empty or in use, so the whole queue may be empty: look at every part
+    for(int i = 0; !popped && i < queue->part_count; i++)
+    {
+        pthread_mutex_lock(&queue->parts[i].lock);
+        popped = popPart(&queue->parts[i], &first_element, &first_priority);
+        pthread_mutex_unlock(&queue->parts[i].lock);
+    }
+    if(!popped)
+    {
+        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    }
+    if(element != NULL)
+    {
+        *element = first_element;
+    }
+    else
+    {
+        queue->freeElementFunction(first_element);
+    }
+    if(priority != NULL)
+    {
+        *priority = first_priority;
+    }
+    else
+    {
+        queue->freeElementPriority(first_priority);
+    }
+    return PQ_SUCCESS;
+}
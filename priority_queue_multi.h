@@ -0,0 +1,114 @@
+#ifndef PRIORITY_QUEUE_MULTI_H
+#define PRIORITY_QUEUE_MULTI_H
+
+#include "priority_queue.h"
+
+/**
+* Relaxed Multi Priority Queue Container
+*
+* A priority queue for many threads that trades the exact order for throughput (a MultiQueue,
+* Rihani et al.). It is made of a number of binary heap priority queues, each with its own
+* lock. An insertion goes into a random one of them, and a pop looks at the first elements
+* of two random ones and pops the better of the two. If a queue it picked is in use, a thread
+* picks another instead of waiting. Only after a few tries does it wait for a lock: an insertion
+* for the lock of the queue it picked last, a pop for the lock of each queue in turn.
+* So a pop returns one of the first elements, not always the first one. With q internal
+* queues the popped element is about q places from the first on average (see
+* benchmarks/priority_queue_multi_benchmark, which measures this rank error). A good number
+* of internal queues is 2 to 4 times the number of threads. With a single internal queue the
+* order is exact.
+* Between equal priorities the insertion order is only kept inside each internal queue.
+*
+* The following functions are available:
+*   mpqCreate		    - Creates a new empty multi priority queue
+*   mpqDestroy		    - Deletes an existing multi priority queue and frees all resources
+*   mpqGetSize		    - Returns the number of elements in a multi priority queue
+*   mpqInsert	        - Insert an element with a given priority to the queue.
+*   mpqRemove		    - Removes one of the highest priority elements in the queue
+*   mpqPopFirst         - Removes one of the highest priority elements and hands it over to the caller
+*/
+
+/** Type for defining the multi priority queue */
+typedef struct MultiPriorityQueue_t *MultiPriorityQueue;
+
+/**
+* mpqCreate: Allocates a new empty multi priority queue.
+* The functions are called from the threads using the queue, possibly from several of them at once.
+*
+* @param queue_count - The number of internal priority queues.
+* @param copy_element - Function pointer to be used for copying data elements into the queue.
+* @param free_element - Function pointer to be used for freeing data elements.
+* @param copy_priority - Function pointer to be used for copying priorities into the queue.
+* @param free_priority - Function pointer to be used for freeing priorities.
+* @param compare_priorities - Function pointer to be used for comparing priorities.
+* @return
+* 	NULL - if one of the parameters is NULL, queue_count is not positive or allocations failed.
+* 	A new multi priority queue in case of success.
+*/
+MultiPriorityQueue mpqCreate(int queue_count,
+                             CopyPQElement copy_element,
+                             FreePQElement free_element,
+                             CopyPQElementPriority copy_priority,
+                             FreePQElementPriority free_priority,
+                             ComparePQElementPriorities compare_priorities);
+
+/**
+* mpqDestroy: Deallocates an existing multi priority queue. Clears all elements by using the
+* free functions. No other thread may be using the queue.
+*
+* @param queue - Target queue to be deallocated. If queue is NULL nothing will be done
+*/
+void mpqDestroy(MultiPriorityQueue queue);
+
+/**
+* mpqGetSize: Returns the number of elements in a multi priority queue. While other threads
+* insert or pop, it is only a snapshot of each internal queue at a slightly different moment.
+*
+* @param queue - The multi priority queue whose size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the queue.
+*/
+int mpqGetSize(MultiPriorityQueue queue);
+
+/**
+*   mpqInsert: add a copy of an element with a specific priority.
+*
+* @param queue - The multi priority queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The priority to associate with the given element.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_OUT_OF_MEMORY if an allocation failed
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult mpqInsert(MultiPriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/**
+*   mpqRemove: Removes one of the highest priority elements, as mpqPopFirst picks it, and frees it
+*   using the free functions.
+*
+* @param queue - The multi priority queue to remove the element from.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent to the function.
+* 	PQ_SUCCESS an element had been removed successfully, or the queue was empty.
+*/
+PriorityQueueResult mpqRemove(MultiPriorityQueue queue);
+
+/**
+*   mpqPopFirst: Removes one of the highest priority elements from the queue without freeing it:
+*   the better of the first elements of two internal queues. The element and its priority are
+*   handed over to the caller, who becomes responsible for freeing them.
+*   It only reports an empty queue after finding every internal queue empty.
+*
+* @param queue - The multi priority queue to pop the element from.
+* @param element - Where to store the popped element. If NULL, the element is freed using the free function.
+* @param priority - Where to store the popped priority. If NULL, the priority is freed using the free function.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ELEMENT_DOES_NOT_EXISTS if the queue is empty.
+* 	PQ_SUCCESS an element had been popped successfully.
+*/
+PriorityQueueResult mpqPopFirst(MultiPriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+#endif /* PRIORITY_QUEUE_MULTI_H */
@@ -0,0 +1,231 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "priority_queue_internal.h"
+
+/**
+* Pairing heap engine: the nodes form a tree where every node comes before its
+* children. Every node keeps its first child, its siblings and its parent, so two
+* trees are linked with one comparison. Inserting and melding a whole other queue
+* are O(1), unlinking a node is O(log n) amortized.
+* The heap does not keep a full order, iterating is done by the generic part over a
+* sorted snapshot.
+*/
+
+typedef struct PairingState_t
+{
+    Node root;
+}*PairingState;
+
+static bool pairingInit(PriorityQueue queue);
+static void pairingRelease(PriorityQueue queue);
+static bool pairingInsert(PriorityQueue queue, Node node);
+static void pairingDetach(PriorityQueue queue, Node node);
+static Node pairingFirst(PriorityQueue queue);
+static void pairingVisitAll(PriorityQueue queue, NodeVisitor visit, void* context);
+static void pairingReset(PriorityQueue queue);
+static bool pairingBuild(PriorityQueue queue, Node* nodes, int count);
+static void pairingMeld(PriorityQueue queue, PriorityQueue other);
+static void pairingVisitChildren(PriorityQueue queue, Node node, NodeVisitor visit, void* context);
+
+//links two roots, the one that comes later becomes the first child of the other. Returns the new root
+static Node pairingLink(PriorityQueue queue, Node a, Node b);
+
+//links a list of siblings into a single tree, in pairs from the first to the last and then
+//from the last pair back to the first. Returns its root, NULL for an empty list
+static Node pairingMergeSiblings(PriorityQueue queue, Node first);
+
+//returns the first node of the subtree of node in post order
+static Node pairingDeepestFirst(Node node);
+
+const PQEngine pqPairingHeapEngine = {
+    pairingInit,
+    pairingRelease,
+    pairingInsert,
+    pairingInsert,
+    pairingDetach,
+    pairingFirst,
+    NULL,
+    pairingVisitAll,
+    pairingReset,
+    NULL,
+    pairingBuild,
+    pairingMeld,
+    pairingVisitChildren,
+    NULL
+};
+
+static bool pairingInit(PriorityQueue queue)
+{
+    PairingState state = malloc(sizeof(*state));
+    if(state == NULL)
+    {
+        return false;
+    }
+    state->root = NULL;
+    queue->engine_state = state;
+    return true;
+}
+
+static void pairingRelease(PriorityQueue queue)
+{
+    free(queue->engine_state);
+    queue->engine_state = NULL;
+}
+
+static Node pairingLink(PriorityQueue queue, Node a, Node b)
+{
+    assert(a->parent == NULL && a->next == NULL && b->parent == NULL && b->next == NULL);
+    if(pqNodeBefore(queue, b, a))
+    {
+        Node swap = a;
+        a = b;
+        b = swap;
+    }
+    b->next = a->child;
+    if(a->child != NULL)
+    {
+        a->child->prev = b;
+    }
+    b->prev = NULL;
+    b->parent = a;
+    a->child = b;
+    return a;
+}
+
+static Node pairingMergeSiblings(PriorityQueue queue, Node first)
+{
+    //first pass: link the siblings in pairs, and stack the results through next
+    Node pairs = NULL;
+    while(first != NULL)
+    {
+        Node a = first;
+        Node b = a->next;
+        first = b == NULL ? NULL : b->next;
+        a->next = a->prev = a->parent = NULL;
+        if(b != NULL)
+        {
+            b->next = b->prev = b->parent = NULL;
+            a = pairingLink(queue, a, b);
+        }
+        a->next = pairs;
+        pairs = a;
+    }
+    if(pairs == NULL)
+    {
+        return NULL;
+    }
+    //second pass: link the pairs into one tree, starting from the last pair
+    Node root = pairs;
+    pairs = pairs->next;
+    root->next = NULL;
+    while(pairs != NULL)
+    {
+        Node next = pairs->next;
+        pairs->next = NULL;
+        root = pairingLink(queue, root, pairs);
+        pairs = next;
+    }
+    return root;
+}
+
+static bool pairingInsert(PriorityQueue queue, Node node)
+{
+    PairingState state = queue->engine_state;
+    node->child = node->parent = node->next = node->prev = NULL;
+    state->root = state->root == NULL ? node : pairingLink(queue, state->root, node);
+    return true;
+}
+
+static bool pairingBuild(PriorityQueue queue, Node* nodes, int count)
+{
+    for(int i = 0; i < count; i++)
+    {
+        pairingInsert(queue, nodes[i]);
+    }
+    return true;
+}
+
+static void pairingMeld(PriorityQueue queue, PriorityQueue other)
+{
+    PairingState state = queue->engine_state;
+    PairingState other_state = other->engine_state;
+    if(other_state->root != NULL)
+    {
+        state->root = state->root == NULL ? other_state->root : pairingLink(queue, state->root, other_state->root);
+    }
+    other_state->root = NULL;
+}
+
+static void pairingDetach(PriorityQueue queue, Node node)
+{
+    PairingState state = queue->engine_state;
+    Node subtree = pairingMergeSiblings(queue, node->child);
+    if(node == state->root)
+    {
+        state->root = subtree;
+    }
+    else
+    {
+        //cut node out of its siblings, its children go back in as one tree
+        if(node->prev == NULL)
+        {
+            node->parent->child = node->next;
+        }
+        else
+        {
+            node->prev->next = node->next;
+        }
+        if(node->next != NULL)
+        {
+            node->next->prev = node->prev;
+        }
+        node->next = node->prev = node->parent = NULL;
+        if(subtree != NULL)
+        {
+            state->root = pairingLink(queue, state->root, subtree);
+        }
+    }
+    node->child = node->parent = node->next = node->prev = NULL;
+}
+
+static Node pairingFirst(PriorityQueue queue)
+{
+    PairingState state = queue->engine_state;
+    return state->root;
+}
+
+static Node pairingDeepestFirst(Node node)
+{
+    while(node->child != NULL)
+    {
+        node = node->child;
+    }
+    return node;
+}
+
+static void pairingVisitAll(PriorityQueue queue, NodeVisitor visit, void* context)
+{
+    PairingState state = queue->engine_state;
+    //post order: the children of a node are visited before it, so a visited node is never read again
+    Node current = state->root == NULL ? NULL : pairingDeepestFirst(state->root);
+    while(current != NULL)
+    {
+        Node following = current->next != NULL ? pairingDeepestFirst(current->next) : current->parent;
+        visit(queue, current, context);
+        current = following;
+    }
+}
+
+static void pairingVisitChildren(PriorityQueue queue, Node node, NodeVisitor visit, void* context)
+{
+    for(Node child = node->child; child != NULL; child = child->next)
+    {
+        visit(queue, child, context);
+    }
+}
+
+static void pairingReset(PriorityQueue queue)
+{
+    PairingState state = queue->engine_state;
+    state->root = NULL;
+}
@@ -0,0 +1,304 @@
+#include <stdlib.h>
+#include "priority_queue_internal.h"
+
+/**
+* Radix heap engine, for queues whose priorities map to integer keys (see pqCreateKeyed) and
+* that are used monotonically: nothing is inserted before the last node that came first.
+* The engine remembers the key of the first node, last. Every node is kept in bucket b, b
+* being the length in bits of the difference between its key and last: bucket 0 holds the
+* nodes whose key is last, in insertion order, bucket b > 0 the keys that first differ from
+* last at bit b - 1. Inserting appends to a bucket, O(1).
+* When bucket 0 runs out, the lowest bucket that is not empty is emptied: last becomes its
+* smallest key, and every node in it moves to a lower bucket. A node only ever moves down,
+* so unlinking the first node is O(log C) amortized, C being the range of the keys.
+* A node inserted before last makes the engine redistribute all of its nodes, O(n).
+*/
+
+#define RADIX_BUCKETS ((int) (sizeof(unsigned long) * CHAR_BIT) + 1)
+
+typedef struct RadixBucket_t
+{
+    Node head;
+    Node tail;
+} RadixBucket;
+
+typedef struct RadixState_t
+{
+    RadixBucket buckets[RADIX_BUCKETS];
+    unsigned long last; //the key of the nodes in bucket 0
+    int count;
+}*RadixState;
+
+static bool radixInit(PriorityQueue queue);
+static void radixRelease(PriorityQueue queue);
+static bool radixInsert(PriorityQueue queue, Node node);
+static void radixDetach(PriorityQueue queue, Node node);
+static bool radixBuild(PriorityQueue queue, Node* nodes, int count);
+static Node radixFirst(PriorityQueue queue);
+static void radixVisitAll(PriorityQueue queue, NodeVisitor visit, void* context);
+static void radixReset(PriorityQueue queue);
+
+//returns the bucket a node with the given key belongs in
+static int radixBucketOf(RadixState state, unsigned long key);
+
+//adds node to the bucket its key belongs in. Bucket 0 is kept in insertion order
+static void radixLink(PriorityQueue queue, RadixState state, Node node);
+
+//unlinks node from its bucket
+static void radixUnlink(RadixState state, Node node);
+
+//makes key the new last, moving every node to the bucket it belongs in now. Every key must be at least key
+static void radixRebase(PriorityQueue queue, RadixState state, unsigned long key);
+
+//refills bucket 0 from the lowest bucket that is not empty
+static void radixRefill(PriorityQueue queue, RadixState state);
+
+const PQEngine pqRadixHeapEngine = {
+    radixInit,
+    radixRelease,
+    radixInsert,
+    radixInsert,
+    radixDetach,
+    radixFirst,
+    NULL,
+    radixVisitAll,
+    radixReset,
+    NULL,
+    radixBuild,
+    NULL,
+    NULL,
+    NULL
+};
+
+static bool radixInit(PriorityQueue queue)
+{
+    //without keys there is nothing to sort the nodes into buckets by
+    if(queue->priorityKeyFunction == NULL)
+    {
+        return false;
+    }
+    RadixState state = malloc(sizeof(*state));
+    if(state == NULL)
+    {
+        return false;
+    }
+    queue->engine_state = state;
+    radixReset(queue);
+    return true;
+}
+
+static void radixRelease(PriorityQueue queue)
+{
+    free(queue->engine_state);
+    queue->engine_state = NULL;
+}
+
+static int radixBucketOf(RadixState state, unsigned long key)
+{
+    unsigned long difference = key ^ state->last;
+    int bucket = 0;
+    while(difference != 0)
+    {
+        difference >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static void radixLink(PriorityQueue queue, RadixState state, Node node)
+{
+    int bucket = radixBucketOf(state, pqNodeKey(queue, node));
+    RadixBucket* target = &state->buckets[bucket];
+    Node previous = target->tail;
+    //the nodes of bucket 0 are equal, their insertion stamps decide. The others are sorted when they reach it
+    if(bucket == 0)
+    {
+        while(previous != NULL && previous->sequence > node->sequence)
+        {
+            previous = previous->prev;
+        }
+    }
+    node->index = bucket;
+    node->prev = previous;
+    node->next = previous != NULL ? previous->next : target->head;
+    if(node->next != NULL)
+    {
+        node->next->prev = node;
+    }
+    else
+    {
+        target->tail = node;
+    }
+    if(previous != NULL)
+    {
+        previous->next = node;
+    }
+    else
+    {
+        target->head = node;
+    }
+}
+
+static void radixUnlink(RadixState state, Node node)
+{
+    RadixBucket* bucket = &state->buckets[node->index];
+    if(node->prev != NULL)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        bucket->head = node->next;
+    }
+    if(node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        bucket->tail = node->prev;
+    }
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+static void radixRebase(PriorityQueue queue, RadixState state, unsigned long key)
+{
+    //every bucket is chained into one list first, so no node is linked twice
+    Node chain = NULL;
+    for(int bucket = RADIX_BUCKETS - 1; bucket >= 0; bucket--)
+    {
+        RadixBucket* current = &state->buckets[bucket];
+        if(current->tail != NULL)
+        {
+            current->tail->next = chain;
+            chain = current->head;
+        }
+        current->head = NULL;
+        current->tail = NULL;
+    }
+    state->last = key;
+    while(chain != NULL)
+    {
+        Node next = chain->next;
+        radixLink(queue, state, chain);
+        chain = next;
+    }
+}
+
+static void radixRefill(PriorityQueue queue, RadixState state)
+{
+    int bucket = 1;
+    while(state->buckets[bucket].head == NULL)
+    {
+        bucket++;
+    }
+    Node chain = state->buckets[bucket].head;
+    unsigned long smallest = pqNodeKey(queue, chain);
+    for(Node node = chain->next; node != NULL; node = node->next)
+    {
+        unsigned long key = pqNodeKey(queue, node);
+        smallest = key < smallest ? key : smallest;
+    }
+    state->buckets[bucket].head = NULL;
+    state->buckets[bucket].tail = NULL;
+    //the keys in the bucket only differ from smallest below bit bucket - 1, they all move lower
+    state->last = smallest;
+    while(chain != NULL)
+    {
+        Node next = chain->next;
+        radixLink(queue, state, chain);
+        chain = next;
+    }
+}
+
+static bool radixInsert(PriorityQueue queue, Node node)
+{
+    RadixState state = queue->engine_state;
+    unsigned long key = pqNodeKey(queue, node);
+    if(state->count == 0)
+    {
+        state->last = key;
+    }
+    else if(key < state->last)
+    {
+        radixRebase(queue, state, key);
+    }
+    radixLink(queue, state, node);
+    state->count++;
+    return true;
+}
+
+static bool radixBuild(PriorityQueue queue, Node* nodes, int count)
+{
+    RadixState state = queue->engine_state;
+    if(count == 0)
+    {
+        return true;
+    }
+    //rebasing once on the smallest key keeps unordered nodes from rebasing at every insertion
+    unsigned long smallest = pqNodeKey(queue, nodes[0]);
+    for(int i = 1; i < count; i++)
+    {
+        unsigned long key = pqNodeKey(queue, nodes[i]);
+        smallest = key < smallest ? key : smallest;
+    }
+    if(state->count == 0)
+    {
+        state->last = smallest;
+    }
+    else if(smallest < state->last)
+    {
+        radixRebase(queue, state, smallest);
+    }
+    for(int i = 0; i < count; i++)
+    {
+        radixLink(queue, state, nodes[i]);
+    }
+    state->count += count;
+    return true;
+}
+
+static void radixDetach(PriorityQueue queue, Node node)
+{
+    RadixState state = queue->engine_state;
+    radixUnlink(state, node);
+    state->count--;
+    if(state->count > 0 && state->buckets[0].head == NULL)
+    {
+        radixRefill(queue, state);
+    }
+}
+
+static Node radixFirst(PriorityQueue queue)
+{
+    RadixState state = queue->engine_state;
+    return state->buckets[0].head;
+}
+
+static void radixVisitAll(PriorityQueue queue, NodeVisitor visit, void* context)
+{
+    RadixState state = queue->engine_state;
+    for(int bucket = 0; bucket < RADIX_BUCKETS; bucket++)
+    {
+        Node current = state->buckets[bucket].head;
+        while(current != NULL)
+        {
+            Node next = current->next;
+            visit(queue, current, context);
+            current = next;
+        }
+    }
+}
+
+static void radixReset(PriorityQueue queue)
+{
+    RadixState state = queue->engine_state;
+    for(int bucket = 0; bucket < RADIX_BUCKETS; bucket++)
+    {
+        state->buckets[bucket].head = NULL;
+        state->buckets[bucket].tail = NULL;
+    }
+    state->last = 0;
+    state->count = 0;
+}
@@ -0,0 +1,320 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "priority_queue_internal.h"
+
+/**
+* Skiplist engine: the nodes are kept in a doubly linked list sorted by priority, as in
+* the list engine, with express lanes above it. Every node is on the lowest level, and
+* on each level above it with probability 1/4, so a search skips most of the list:
+* inserting and unlinking a node are O(log n) expected. The lowest level is linked
+* through next and prev, advancing an iterator and finding the first or the last node
+* are O(1).
+* The next nodes on the higher levels (a node's tower) are taken from chunks owned by
+* the engine, towers of unlinked nodes are reused by later insertions of the same height.
+* A node whose tower can not be allocated is only linked on the lowest level, so linking a
+* node never fails: a node that was just unlinked can always be linked again.
+*/
+
+#define SKIPLIST_MAX_LEVEL 16
+#define SKIPLIST_CHUNK_POINTERS 1024
+#define SKIPLIST_SEED 0x9E3779B9u
+
+typedef struct TowerChunk_t
+{
+    struct TowerChunk_t* next;
+    Node pointers[];
+}*TowerChunk;
+
+typedef struct SkiplistState_t
+{
+    Node heads[SKIPLIST_MAX_LEVEL]; //the first node on every level
+    Node tail;
+    int levels;                     //the levels in use, the lowest one always is
+    unsigned random_state;
+    TowerChunk chunks;
+    int chunk_used;                 //pointers handed out from the newest chunk
+    Node* free_towers[SKIPLIST_MAX_LEVEL]; //towers of unlinked nodes by height, chained through their first pointer
+}*SkiplistState;
+
+//a tower taken for a node before it is linked
+typedef struct SkiplistTower_t
+{
+    Node* tower;
+    int height;
+} SkiplistTower;
+
+static bool skiplistInit(PriorityQueue queue);
+static void skiplistRelease(PriorityQueue queue);
+static bool skiplistInsert(PriorityQueue queue, Node node);
+static void skiplistDetach(PriorityQueue queue, Node node);
+static bool skiplistBuild(PriorityQueue queue, Node* nodes, int count);
+static Node skiplistFirst(PriorityQueue queue);
+static Node skiplistSuccessor(PriorityQueue queue, Node node);
+static Node skiplistLast(PriorityQueue queue);
+static void skiplistVisitAll(PriorityQueue queue, NodeVisitor visit, void* context);
+static void skiplistReset(PriorityQueue queue);
+
+//returns where the next node after node on level is kept, the level's head if node is NULL
+static Node* skiplistNextOf(SkiplistState state, Node node, int level);
+
+//returns a random height between 1 and SKIPLIST_MAX_LEVEL, every level is 4 times rarer than the one below
+static int skiplistRandomHeight(SkiplistState state);
+
+//takes a tower for a node of a random height. If the allocation fails the node gets height 1, which needs none
+static SkiplistTower skiplistTakeTower(SkiplistState state);
+
+//gives back the tower of a node of the given height
+static void skiplistGiveTower(SkiplistState state, int height, Node* tower);
+
+//stores in predecessors the last node before node on every level in use, NULL for the level's head
+static void skiplistFindPredecessors(PriorityQueue queue, SkiplistState state, Node node, Node* predecessors);
+
+//links node into every level below height, using the tower taken for it
+static void skiplistLink(PriorityQueue queue, SkiplistState state, Node node, SkiplistTower tower);
+
+const PQEngine pqSkiplistEngine = {
+    skiplistInit,
+    skiplistRelease,
+    skiplistInsert,
+    skiplistInsert,
+    skiplistDetach,
+    skiplistFirst,
+    skiplistSuccessor,
+    skiplistVisitAll,
+    skiplistReset,
+    NULL,
+    skiplistBuild,
+    NULL,
+    NULL,
+    skiplistLast
+};
+
+static bool skiplistInit(PriorityQueue queue)
+{
+    SkiplistState state = malloc(sizeof(*state));
+    if(state == NULL)
+    {
+        return false;
+    }
+    state->chunks = NULL;
+    state->random_state = SKIPLIST_SEED;
+    queue->engine_state = state;
+    skiplistReset(queue);
+    return true;
+}
+
+static void skiplistRelease(PriorityQueue queue)
+{
+    skiplistReset(queue);
+    free(queue->engine_state);
+    queue->engine_state = NULL;
+}
+
+static Node* skiplistNextOf(SkiplistState state, Node node, int level)
+{
+    if(node == NULL)
+    {
+        return &state->heads[level];
+    }
+    return level == 0 ? &node->next : &node->forward[level - 1];
+}
+
+static int skiplistRandomHeight(SkiplistState state)
+{
+    int height = 1;
+    while(height < SKIPLIST_MAX_LEVEL)
+    {
+        state->random_state ^= state->random_state << 13;
+        state->random_state ^= state->random_state >> 17;
+        state->random_state ^= state->random_state << 5;
+        if((state->random_state & 3) != 0)
+        {
+            break;
+        }
+        height++;
+    }
+    return height;
+}
+
+static SkiplistTower skiplistTakeTower(SkiplistState state)
+{
+    SkiplistTower tower = {NULL, skiplistRandomHeight(state)};
+    if(tower.height == 1)
+    {
+        return tower;
+    }
+    if(state->free_towers[tower.height - 1] != NULL)
+    {
+        tower.tower = state->free_towers[tower.height - 1];
+        state->free_towers[tower.height - 1] = (Node*) (void*) tower.tower[0];
+        return tower;
+    }
+    if(state->chunks == NULL || state->chunk_used + tower.height - 1 > SKIPLIST_CHUNK_POINTERS)
+    {
+        TowerChunk chunk = malloc(sizeof(*chunk) + sizeof(Node) * SKIPLIST_CHUNK_POINTERS);
+        if(chunk == NULL)
+        {
+            tower.height = 1;
+            return tower;
+        }
+        chunk->next = state->chunks;
+        state->chunks = chunk;
+        state->chunk_used = 0;
+    }
+    tower.tower = state->chunks->pointers + state->chunk_used;
+    state->chunk_used += tower.height - 1;
+    return tower;
+}
+
+static void skiplistGiveTower(SkiplistState state, int height, Node* tower)
+{
+    if(height == 1)
+    {
+        return;
+    }
+    tower[0] = (Node) (void*) state->free_towers[height - 1];
+    state->free_towers[height - 1] = tower;
+}
+
+static void skiplistFindPredecessors(PriorityQueue queue, SkiplistState state, Node node, Node* predecessors)
+{
+    Node current = NULL;
+    for(int level = state->levels - 1; level >= 0; level--)
+    {
+        Node next = *skiplistNextOf(state, current, level);
+        while(next != NULL && pqNodeBefore(queue, next, node))
+        {
+            current = next;
+            next = *skiplistNextOf(state, current, level);
+        }
+        predecessors[level] = current;
+    }
+}
+
+static void skiplistLink(PriorityQueue queue, SkiplistState state, Node node, SkiplistTower tower)
+{
+    Node predecessors[SKIPLIST_MAX_LEVEL];
+    skiplistFindPredecessors(queue, state, node, predecessors);
+    //the levels that were not in use only have the head before node
+    for(; state->levels < tower.height; state->levels++)
+    {
+        predecessors[state->levels] = NULL;
+    }
+    node->forward = tower.tower;
+    node->index = tower.height;
+    for(int level = 0; level < tower.height; level++)
+    {
+        Node* link = skiplistNextOf(state, predecessors[level], level);
+        *skiplistNextOf(state, node, level) = *link;
+        *link = node;
+    }
+    node->prev = predecessors[0];
+    if(node->next != NULL)
+    {
+        node->next->prev = node;
+    }
+    else
+    {
+        state->tail = node;
+    }
+}
+
+static bool skiplistInsert(PriorityQueue queue, Node node)
+{
+    SkiplistState state = queue->engine_state;
+    skiplistLink(queue, state, node, skiplistTakeTower(state));
+    return true;
+}
+
+static bool skiplistBuild(PriorityQueue queue, Node* nodes, int count)
+{
+    SkiplistState state = queue->engine_state;
+    for(int i = 0; i < count; i++)
+    {
+        skiplistLink(queue, state, nodes[i], skiplistTakeTower(state));
+    }
+    return true;
+}
+
+static void skiplistDetach(PriorityQueue queue, Node node)
+{
+    SkiplistState state = queue->engine_state;
+    int height = node->index;
+    Node predecessors[SKIPLIST_MAX_LEVEL];
+    if(height > 1)
+    {
+        skiplistFindPredecessors(queue, state, node, predecessors);
+    }
+    //the lowest level is doubly linked, it needs no search
+    predecessors[0] = node->prev;
+    for(int level = 0; level < height; level++)
+    {
+        Node* link = skiplistNextOf(state, predecessors[level], level);
+        assert(*link == node);
+        *link = *skiplistNextOf(state, node, level);
+    }
+    if(node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        state->tail = node->prev;
+    }
+    while(state->levels > 1 && state->heads[state->levels - 1] == NULL)
+    {
+        state->levels--;
+    }
+    skiplistGiveTower(state, height, node->forward);
+    node->forward = NULL;
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+static Node skiplistFirst(PriorityQueue queue)
+{
+    SkiplistState state = queue->engine_state;
+    return state->heads[0];
+}
+
+static Node skiplistSuccessor(PriorityQueue queue, Node node)
+{
+    return node->next;
+}
+
+static Node skiplistLast(PriorityQueue queue)
+{
+    SkiplistState state = queue->engine_state;
+    return state->tail;
+}
+
+static void skiplistVisitAll(PriorityQueue queue, NodeVisitor visit, void* context)
+{
+    SkiplistState state = queue->engine_state;
+    Node current = state->heads[0];
+    while(current != NULL)
+    {
+        Node next = current->next;
+        visit(queue, current, context);
+        current = next;
+    }
+}
+
+static void skiplistReset(PriorityQueue queue)
+{
+    SkiplistState state = queue->engine_state;
+    while(state->chunks != NULL)
+    {
+        TowerChunk next = state->chunks->next;
+        free(state->chunks);
+        state->chunks = next;
+    }
+    for(int level = 0; level < SKIPLIST_MAX_LEVEL; level++)
+    {
+        state->heads[level] = NULL;
+        state->free_towers[level] = NULL;
+    }
+    state->tail = NULL;
+    state->levels = 1;
+    state->chunk_used = 0;
+}
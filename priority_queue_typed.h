@@ -0,0 +1,219 @@
+#ifndef PRIORITY_QUEUE_TYPED_H
+#define PRIORITY_QUEUE_TYPED_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "priority_queue.h"
+
+/**
+* Type Specialized Priority Queue Generator
+*
+* PQ_DEFINE(name, ElemType, PrioType, cmp_expr) stamps out a priority queue of
+* ElemType elements with PrioType priorities. It keeps the order of priority_queue.h:
+* the highest priority first, and between equal priorities the element inserted first.
+* Elements and priorities are stored by value in one array backed binary heap, so there
+* are no copy or free functions and no allocation per element. cmp_expr compares two
+* priorities named a and b and is inlined into every comparison. It should evaluate to:
+* 		A positive integer if a is the higher priority;
+* 		0 if they're equal;
+*		A negative integer if b is the higher priority.
+* Values that own memory are assigned as they are, freeing it stays with the user.
+*
+* For example, PQ_DEFINE(IntPQ, int, int, (a > b) - (a < b)) defines the type IntPQ
+* and the following functions:
+*   IntPQCreate         - Creates a new empty priority queue
+*   IntPQDestroy        - Deletes an existing priority queue and frees all resources
+*   IntPQGetSize        - Returns the size of a given priority queue
+*   IntPQReserve        - Preallocates room for a given number of elements
+*   IntPQInsert         - Insert an element with a given priority to the queue.
+*   IntPQGetFirst       - Returns a pointer to the highest priority element
+*   IntPQGetFirstPriority - Returns a pointer to the priority of the highest priority element
+*   IntPQRemove         - Removes the highest priority element in the queue
+*   IntPQPopFirst       - Removes the highest priority element and returns it with its priority
+*   IntPQClear          - Removes all the elements of the queue
+* The functions return the PriorityQueueResult codes of priority_queue.h, with the same
+* meanings as their generic counterparts.
+*/
+
+#define PQ_TYPED_INITIAL_CAPACITY 16
+#define PQ_TYPED_GROWTH_FACTOR 2
+
+#define PQ_DEFINE(name, ElemType, PrioType, cmp_expr) \
+\
+typedef struct name##Entry_t \
+{ \
+    ElemType element; \
+    PrioType priority; \
+    unsigned long sequence; \
+} name##Entry; \
+\
+typedef struct name##_t \
+{ \
+    name##Entry* entries; \
+    int size; \
+    int capacity; \
+    unsigned long next_sequence; \
+} *name; \
+\
+static inline int name##ComparePriorities(PrioType a, PrioType b) \
+{ \
+    return (cmp_expr); \
+} \
+\
+/* whether entry x is ordered before entry y: higher priority first, earlier insertion on ties */ \
+static inline bool name##EntryBefore(const name##Entry* x, const name##Entry* y) \
+{ \
+    int delta = name##ComparePriorities(x->priority, y->priority); \
+    return delta != 0 ? delta > 0 : x->sequence < y->sequence; \
+} \
+\
+static inline name name##Create(void) \
+{ \
+    name queue = malloc(sizeof(*queue)); \
+    if(queue == NULL) \
+    { \
+        return NULL; \
+    } \
+    queue->entries = NULL; \
+    queue->size = 0; \
+    queue->capacity = 0; \
+    queue->next_sequence = 0; \
+    return queue; \
+} \
+\
+static inline void name##Destroy(name queue) \
+{ \
+    if(queue == NULL) \
+    { \
+        return; \
+    } \
+    free(queue->entries); \
+    free(queue); \
+} \
+\
+static inline int name##GetSize(name queue) \
+{ \
+    return queue == NULL ? -1 : queue->size; \
+} \
+\
+static inline PriorityQueueResult name##Reserve(name queue, int capacity) \
+{ \
+    if(queue == NULL) \
+    { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    if(capacity <= queue->capacity) \
+    { \
+        return PQ_SUCCESS; \
+    } \
+    name##Entry* entries = realloc(queue->entries, sizeof(*entries) * capacity); \
+    if(entries == NULL) \
+    { \
+        return PQ_OUT_OF_MEMORY; \
+    } \
+    queue->entries = entries; \
+    queue->capacity = capacity; \
+    return PQ_SUCCESS; \
+} \
+\
+static inline PriorityQueueResult name##Insert(name queue, ElemType element, PrioType priority) \
+{ \
+    if(queue == NULL) \
+    { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    if(queue->size == queue->capacity && \
+       name##Reserve(queue, queue->capacity == 0 ? PQ_TYPED_INITIAL_CAPACITY : \
+                            queue->capacity * PQ_TYPED_GROWTH_FACTOR) != PQ_SUCCESS) \
+    { \
+        return PQ_OUT_OF_MEMORY; \
+    } \
+    name##Entry entry = {element, priority, queue->next_sequence++}; \
+    int index = queue->size++; \
+    while(index > 0) \
+    { \
+        int parent = (index - 1) / 2; \
+        if(!name##EntryBefore(&entry, &queue->entries[parent])) \
+        { \
+            break; \
+        } \
+        queue->entries[index] = queue->entries[parent]; \
+        index = parent; \
+    } \
+    queue->entries[index] = entry; \
+    return PQ_SUCCESS; \
+} \
+\
+static inline ElemType* name##GetFirst(name queue) \
+{ \
+    return queue == NULL || queue->size == 0 ? NULL : &queue->entries[0].element; \
+} \
+\
+static inline PrioType* name##GetFirstPriority(name queue) \
+{ \
+    return queue == NULL || queue->size == 0 ? NULL : &queue->entries[0].priority; \
+} \
+\
+static inline PriorityQueueResult name##PopFirst(name queue, ElemType* element, PrioType* priority) \
+{ \
+    if(queue == NULL) \
+    { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    if(queue->size == 0) \
+    { \
+        return PQ_ELEMENT_DOES_NOT_EXISTS; \
+    } \
+    if(element != NULL) \
+    { \
+        *element = queue->entries[0].element; \
+    } \
+    if(priority != NULL) \
+    { \
+        *priority = queue->entries[0].priority; \
+    } \
+    /* the last entry takes the root and sinks to where it belongs */ \
+    name##Entry last = queue->entries[--queue->size]; \
+    int index = 0; \
+    while(true) \
+    { \
+        int child = 2 * index + 1; \
+        if(child >= queue->size) \
+        { \
+            break; \
+        } \
+        if(child + 1 < queue->size && name##EntryBefore(&queue->entries[child + 1], &queue->entries[child])) \
+        { \
+            child++; \
+        } \
+        if(!name##EntryBefore(&queue->entries[child], &last)) \
+        { \
+            break; \
+        } \
+        queue->entries[index] = queue->entries[child]; \
+        index = child; \
+    } \
+    queue->entries[index] = last; \
+    return PQ_SUCCESS; \
+} \
+\
+static inline PriorityQueueResult name##Remove(name queue) \
+{ \
+    if(queue == NULL) \
+    { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    return queue->size == 0 ? PQ_SUCCESS : name##PopFirst(queue, NULL, NULL); \
+} \
+\
+static inline PriorityQueueResult name##Clear(name queue) \
+{ \
+    if(queue == NULL) \
+    { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    queue->size = 0; \
+    return PQ_SUCCESS; \
+}
+
+#endif /* PRIORITY_QUEUE_TYPED_H */
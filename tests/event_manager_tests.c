@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <limits.h>
 
 #include "../event_manager.h"
 #include "../date.h"
@@ -709,6 +710,161 @@ bool testEMTickDeletesPastEvents() {
     return result;
 }
 
+bool testDateValuesRoundTrip() {
+    bool result = true;
+    Date date = NULL;
+    DateValue value;
+    int day, month, year;
+
+    // the value counts days from 1.1.0, years before it are rounded down
+    ASSERT(dateValueMake(1, 1, 0, &value) && value == 0);
+    ASSERT(dateValueMake(30, 12, -1, &value) && value == -1);
+    ASSERT(dateValueMake(1, 1, -1, &value) && value == -360);
+    ASSERT(dateValueGet(-1, &day, &month, &year) && day == 30 && month == 12 && year == -1);
+    ASSERT(dateValueGet(-360, &day, &month, &year) && day == 1 && month == 1 && year == -1);
+    ASSERT(dateValueGet(-361, &day, &month, &year) && day == 30 && month == 12 && year == -2);
+    ASSERT(dateValueGet(-31, &day, &month, &year) && day == 30 && month == 11 && year == -1);
+    for (DateValue v = -1000; v <= 1000; v++) {
+        DateValue back;
+        ASSERT(dateValueGet(v, &day, &month, &year));
+        ASSERT(dateValueMake(day, month, year, &back) && back == v);
+    }
+    ASSERT(dateValueCompare(-361, -360) < 0 && dateValueCompare(5, 5) == 0 && dateValueCompare(0, -1) > 0);
+    ASSERT(dateValueTick(-1) == 0);
+    ASSERT(!dateValueMake(1, 1, 0, NULL));
+    ASSERT(!dateValueGet(0, NULL, &month, &year));
+
+    date = dateCreateFromValue(-361);
+    ASSERT(date != NULL);
+    ASSERT(dateGet(date, &day, &month, &year) && day == 30 && month == 12 && year == -2);
+    ASSERT(dateGetValue(date, &value) && value == -361);
+    ASSERT(!dateGetValue(NULL, &value));
+    ASSERT(!dateGetValue(date, NULL));
+
+    destroy:
+    dateDestroy(date);
+    return result;
+}
+
+bool testDateValuesStayInTheLegalYears() {
+    bool result = true;
+    Date date = NULL;
+    DateValue min, max, value;
+
+    ASSERT(dateValueMake(1, 1, -DATE_MAX_YEAR, &min));
+    ASSERT(dateValueMake(30, 12, DATE_MAX_YEAR, &max));
+    ASSERT(!dateValueMake(30, 12, -DATE_MAX_YEAR - 1, &value));
+    ASSERT(!dateValueMake(1, 1, DATE_MAX_YEAR + 1, &value));
+    date = dateCreate(1, 1, DATE_MAX_YEAR + 1);
+    ASSERT(date == NULL);
+    date = dateCreate(30, 12, DATE_MAX_YEAR);
+    ASSERT(date != NULL);
+
+    // one day past either end is refused, and the value is left as it was
+    value = max;
+    ASSERT(!dateValueAddDays(&value, 1) && value == max);
+    ASSERT(dateValueAddDays(&value, -1) && value == max - 1);
+    value = min;
+    ASSERT(!dateValueAddDays(&value, -1) && value == min);
+    ASSERT(dateValueAddDays(&value, 1) && value == min + 1);
+    ASSERT(dateValueAddDays(&value, max - min - 1) && value == max);
+    ASSERT(!dateValueAddDays(NULL, 1));
+
+    // offsets that would overflow the value are refused too
+    ASSERT(!dateValueAddDays(&value, INT_MAX) && value == max);
+    value = min;
+    ASSERT(!dateValueAddDays(&value, INT_MIN) && value == min);
+    ASSERT(!dateAddDays(date, INT_MAX));
+    ASSERT(dateGetValue(date, &value) && value == max);
+
+    destroy:
+    dateDestroy(date);
+    return result;
+}
+
+bool testDateAddDaysAndDiffDays() {
+    bool result = true;
+    Date date = dateCreate(30, 12, 1999);
+    Date other = dateCreate(1, 1, 2000);
+    int day, month, year;
+
+    ASSERT(dateDiffDays(other, date) == 1);
+    ASSERT(dateAddDays(date, 1));
+    ASSERT(dateCompare(date, other) == 0);
+    ASSERT(dateAddDays(date, 360 * 10 + 30 + 4));
+    ASSERT(dateGet(date, &day, &month, &year) && day == 5 && month == 2 && year == 2010);
+    ASSERT(dateDiffDays(date, other) == 3634);
+    ASSERT(dateDiffDays(other, date) == -3634);
+    ASSERT(dateAddDays(date, -3634 - 360 * 2001));
+    ASSERT(dateGet(date, &day, &month, &year) && day == 1 && month == 1 && year == -1);
+    ASSERT(dateAddDays(date, 0));
+    ASSERT(dateDiffDays(date, NULL) == 0);
+    ASSERT(!dateAddDays(NULL, 1));
+
+    // a date past the legal years is refused and the date is left as it was
+    ASSERT(!dateAddDays(date, 360 * (DATE_MAX_YEAR + 2)));
+    ASSERT(!dateAddDays(date, -360 * DATE_MAX_YEAR));
+    ASSERT(dateGet(date, &day, &month, &year) && day == 1 && month == 1 && year == -1);
+
+    destroy:
+    dateDestroy(date);
+    dateDestroy(other);
+    return result;
+}
+
+bool testEMAddEventByDiffFarAhead() {
+    bool result = true;
+    Date date = NULL;
+    EventManager em = createEM(1, 1, 2000);
+
+    ASSERT(emAddEventByDiff(em, "in a thousand years", 360 * 1000, 1) == EM_SUCCESS);
+    ASSERT(emAddEventByDiff(em, "past the calendar", INT_MAX, 2) == EM_INVALID_DATE);
+    date = dateCreate(1, 1, 3000);
+    ASSERT(emAddEventByDate(em, "in a thousand years", date, 3) == EM_EVENT_ALREADY_EXISTS);
+    ASSERT(emTick(em, INT_MAX) == EM_INVALID_DATE);
+    ASSERT(emTick(em, 360 * 1000) == EM_SUCCESS);
+    ASSERT(emGetEventsAmount(em) == 1);
+    ASSERT(emTick(em, 1) == EM_SUCCESS);
+    ASSERT(emGetEventsAmount(em) == 0);
+
+    destroy:
+    dateDestroy(date);
+    destroyEventManager(em);
+    return result;
+}
+
+bool testEMTickSkipsManyDaysAtOnce() {
+    bool result = true;
+    EventManager em = createEM(1, 1, 2000);
+
+    ASSERT(emAddEventByDiff(em, "tomorrow", 1, 1) == EM_SUCCESS);
+    ASSERT(emAddEventByDiff(em, "next month", 31, 2) == EM_SUCCESS);
+    ASSERT(emAddEventByDiff(em, "next year", 361, 3) == EM_SUCCESS);
+    ASSERT(emAddEventByDiff(em, "in two years", 721, 4) == EM_SUCCESS);
+
+    ASSERT(emTick(em, 360) == EM_SUCCESS);
+    ASSERT(emGetEventsAmount(em) == 2);
+    ASSERT(strcmp(emGetNextEvent(em), "next year") == 0);
+
+    // the event on the new date itself is not expired yet
+    ASSERT(emTick(em, 1) == EM_SUCCESS);
+    ASSERT(emGetEventsAmount(em) == 2);
+    ASSERT(emTick(em, 1000) == EM_SUCCESS);
+    ASSERT(emGetEventsAmount(em) == 0);
+    ASSERT(emAddEventByDiff(em, "after the jump", 0, 5) == EM_SUCCESS);
+    ASSERT(emTick(em, 1) == EM_SUCCESS);
+    ASSERT(emGetEventsAmount(em) == 0);
+
+    // a million years go by in one step, not one day at a time
+    ASSERT(emAddEventByDiff(em, "far ahead", 360 * 1000, 6) == EM_SUCCESS);
+    ASSERT(emTick(em, 360 * 1000000) == EM_SUCCESS);
+    ASSERT(emGetEventsAmount(em) == 0);
+
+    destroy:
+    destroyEventManager(em);
+    return result;
+}
+
 // TODO: add test that emTick does -1 to the event counter of members in deleted events
 
 
@@ -1383,6 +1539,11 @@ bool testTickRemovePrintAndReturnVals_CreatorAdam() {
     X(testEMRemoveMemberFromEventBasicUsage) \
     X(testEMTickBasicErrors) \
     X(testEMTickDeletesPastEvents) \
+    X(testEMTickSkipsManyDaysAtOnce) \
+    X(testDateValuesRoundTrip) \
+    X(testDateValuesStayInTheLegalYears) \
+    X(testDateAddDaysAndDiffDays) \
+    X(testEMAddEventByDiffFarAhead) \
     X(testEMGetEventsAmountBasicErrors) \
     X(testEMGetEventsAmountBasicUsage) \
     X(testEMGetNextEventBasicErrors) \
@@ -1409,7 +1570,7 @@ const char *testNames[] = {
 #undef X
 };
 
-#define NUMBER_TESTS 37
+#define NUMBER_TESTS 42
 
 int main(int argc, char **argv) {
     if (argc == 1) {
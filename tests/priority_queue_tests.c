@@ -1,6 +1,12 @@
 #include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
 #include "test_utilities.h"
 #include "../priority_queue.h"
+#include "../priority_queue_typed.h"
+#include "../priority_queue_concurrent.h"
+#include "../priority_queue_multi.h"
+#include "../priority_queue_blocking.h"
 
 #define PQ PriorityQueue
 
@@ -723,6 +729,1756 @@ bool testPQClearStandardTest() {
 
 
 
+/* ============= TESTING pqCreateWithBackend ============= */
+PriorityQueue createPQWithBackend(PQBackend backend) {
+    return pqCreateWithBackend(backend, copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                               freeIntGeneric, compareIntsGeneric);
+}
+
+// every backend, for the tests that check behaviour all of them share
+const PQBackend allBackends[] = {PQ_BACKEND_LIST, PQ_BACKEND_BINARY_HEAP, PQ_BACKEND_PAIRING_HEAP,
+                                 PQ_BACKEND_MIN_MAX_HEAP, PQ_BACKEND_SKIPLIST, PQ_BACKEND_4_ARY_HEAP,
+                                 PQ_BACKEND_8_ARY_HEAP};
+#define NUMBER_BACKENDS ((int) (sizeof(allBackends) / sizeof(allBackends[0])))
+
+bool testPQCreateWithBackendUnknownBackend() {
+    bool result = true;
+    PQ pq = createPQWithBackend((PQBackend) -1);
+    ASSERT_TEST(pq == NULL, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQBinaryHeapRemovesByPriorityAndInsertionOrder() {
+    bool result = true;
+    PQ pq = createPQWithBackend(PQ_BACKEND_BINARY_HEAP);
+    ASSERT_TEST(pq != NULL, destroy);
+
+    // elements 0..99 with priorities 0..9, every priority shared by ten elements
+    for (int i = 0; i < 100; i++) {
+        int elem = i;
+        int prio = (i * 7) % 10;
+        ASSERT_TEST(pqInsert(pq, &elem, &prio) == PQ_SUCCESS, destroy);
+    }
+    int previous_prio = 10;
+    int previous_elem = -1;
+    for (int i = 0; i < 100; i++) {
+        int *first = pqGetFirst(pq);
+        ASSERT_TEST(first != NULL, destroy);
+        int prio = (*first * 7) % 10;
+        ASSERT_TEST(prio <= previous_prio, destroy);
+        ASSERT_TEST(prio < previous_prio || *first > previous_elem, destroy);
+        previous_prio = prio;
+        previous_elem = *first;
+        ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQBinaryHeapIteratesByPriority() {
+    bool result = true;
+    PQ pq = createPQWithBackend(PQ_BACKEND_BINARY_HEAP);
+    PQ copy = NULL;
+    for (int i = 0; i < 50; i++) {
+        int elem = (i * 31) % 50;
+        ASSERT_TEST(pqInsert(pq, &elem, &elem) == PQ_SUCCESS, destroy);
+    }
+    int elem = 25, new_prio = 100;
+    ASSERT_TEST(pqChangePriority(pq, &elem, &elem, &new_prio) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqRemoveElement(pq, &elem) == PQ_SUCCESS, destroy);
+    copy = pqCopy(pq);
+    ASSERT_TEST(copy != NULL, destroy);
+
+    int expected = 49;
+    PQ_FOREACH(int *, iter, copy) {
+        if (expected == 25) {
+            expected--;
+        }
+        ASSERT_TEST(*iter == expected, destroy);
+        expected--;
+    }
+    ASSERT_TEST(expected == -1, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    pqDestroy(copy);
+    return result;
+}
+
+
+/* ============= TESTING handles ============= */
+bool testPQHandleSampleNullArgument() {
+    bool result = true;
+    PQ pq = createPQ();
+    int elem = 1;
+    PQHandle handle = NULL;
+    ASSERT_TEST(pqInsertWithHandle(pq, &elem, NULL, &handle) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(handle == NULL, destroy);
+    ASSERT_TEST(pqInsertWithHandle(pq, &elem, &elem, &handle) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqChangePriorityByHandle(pq, handle, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqChangePriorityByHandle(pq, NULL, &elem) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqRemoveByHandle(pq, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqRemoveByHandle(NULL, handle) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqGetElementByHandle(pq, NULL) == NULL, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQChangePriorityByHandleReinsertsTheElement() {
+    bool result = true;
+    PQ pq = NULL;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        PQHandle handles[10];
+        for (int i = 0; i < 10; i++) {
+            int prio = i % 3;
+            ASSERT_TEST(pqInsertWithHandle(pq, &i, &prio, &handles[i]) == PQ_SUCCESS, destroy);
+            ASSERT_TEST(*(int *) pqGetElementByHandle(pq, handles[i]) == i, destroy);
+        }
+        // 4 moves from priority 1 to 2, behind every element that already had priority 2
+        int new_prio = 2;
+        ASSERT_TEST(pqChangePriorityByHandle(pq, handles[4], &new_prio) == PQ_SUCCESS, destroy);
+        // 8 moves from priority 2 to the top
+        new_prio = 3;
+        ASSERT_TEST(pqChangePriorityByHandle(pq, handles[8], &new_prio) == PQ_SUCCESS, destroy);
+
+        int expected[] = {8, 2, 5, 4, 1, 7, 0, 3, 6, 9};
+        int i = 0;
+        PQ_FOREACH(int *, iter, pq) {
+            ASSERT_TEST(*iter == expected[i], destroy);
+            i++;
+        }
+        ASSERT_TEST(i == 10, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQRemoveByHandleRemovesOnlyThatElement() {
+    bool result = true;
+    PQ pq = NULL;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        PQHandle handles[20];
+        int same = 7;
+        for (int i = 0; i < 20; i++) {
+            ASSERT_TEST(pqInsertWithHandle(pq, &same, &i, &handles[i]) == PQ_SUCCESS, destroy);
+        }
+        // every element is equal, the handles still tell them apart
+        for (int i = 0; i < 20; i += 2) {
+            ASSERT_TEST(pqRemoveByHandle(pq, handles[i]) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqGetSize(pq) == 10, destroy);
+        int new_prio = 100;
+        ASSERT_TEST(pqChangePriorityByHandle(pq, handles[1], &new_prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+        for (int i = 19; i > 1; i -= 2) {
+            ASSERT_TEST(pqGetFirst(pq) == pqGetElementByHandle(pq, handles[i]), destroy);
+            ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+
+/* ============= TESTING pqCreateHashed ============= */
+static unsigned long hashIntGeneric(PQElement n) {
+    return (unsigned long) *(int *) n;
+}
+
+PriorityQueue createHashedPQ(PQBackend backend) {
+    return pqCreateHashed(backend, copyIntGeneric, freeIntGeneric, equalIntsGeneric, hashIntGeneric,
+                          copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+}
+
+bool testPQHashedFindsAndRemovesHighestPriorityEqualElement() {
+    bool result = true;
+    PQ pq = NULL;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createHashedPQ(allBackends[b]);
+        ASSERT_TEST(pq != NULL, destroy);
+        // 1000 elements: every value 0..99 ten times, the copy with the highest priority is the last one
+        for (int i = 0; i < 1000; i++) {
+            int elem = i % 100;
+            ASSERT_TEST(pqInsert(pq, &elem, &i) == PQ_SUCCESS, destroy);
+        }
+        int missing = 100;
+        ASSERT_TEST(pqContains(pq, &missing) == false, destroy);
+        ASSERT_TEST(pqFind(pq, &missing) == NULL, destroy);
+        for (int elem = 0; elem < 100; elem++) {
+            ASSERT_TEST(pqContains(pq, &elem) == true, destroy);
+            ASSERT_TEST(*(int *) pqFind(pq, &elem) == elem, destroy);
+            ASSERT_TEST(pqRemoveElement(pq, &elem) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqGetSize(pq) == 900, destroy);
+        // the removed copies were the ones with priorities 900..999
+        int *first = pqGetFirst(pq);
+        ASSERT_TEST(first != NULL && *first == 99, destroy);
+        int old_prio = 5, new_prio = 2000, elem = 5;
+        ASSERT_TEST(pqChangePriority(pq, &elem, &old_prio, &new_prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == 5, destroy);
+        ASSERT_TEST(pqChangePriority(pq, &elem, &old_prio, &new_prio) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQHashedCopyAndClearKeepTheIndex() {
+    bool result = true;
+    PQ pq = createHashedPQ(PQ_BACKEND_LIST);
+    PQ copy = NULL;
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+    }
+    copy = pqCopy(pq);
+    ASSERT_TEST(copy != NULL, destroy);
+    ASSERT_TEST(pqClear(pq) == PQ_SUCCESS, destroy);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TEST(pqContains(pq, &i) == false, destroy);
+        ASSERT_TEST(pqContains(copy, &i) == true, destroy);
+    }
+    int elem = 42;
+    ASSERT_TEST(pqInsert(pq, &elem, &elem) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqContains(pq, &elem) == true, destroy);
+    ASSERT_TEST(pqRemoveElement(copy, &elem) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqContains(copy, &elem) == false, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    pqDestroy(copy);
+    return result;
+}
+
+
+/* ============= TESTING pqReserve ============= */
+bool testPQReserveSampleNullArgument() {
+    bool result = true;
+    ASSERT_TEST(pqReserve(NULL, 10) == PQ_NULL_ARGUMENT, destroy);
+
+    destroy:
+    return result;
+}
+
+bool testPQReserveThenChurnReusesNodes() {
+    bool result = true;
+    PQ pq = NULL;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createHashedPQ(allBackends[b]);
+        ASSERT_TEST(pqReserve(pq, 1000) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        for (int round = 0; round < 3; round++) {
+            for (int i = 0; i < 1000; i++) {
+                int prio = (i * 37) % 1000;
+                ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+            }
+            // fewer than reserved is a no-op
+            ASSERT_TEST(pqReserve(pq, 10) == PQ_SUCCESS, destroy);
+            for (int expected = 999; expected >= 0; expected--) {
+                int *first = pqGetFirst(pq);
+                ASSERT_TEST(first != NULL && (*first * 37) % 1000 == expected, destroy);
+                ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+            }
+            ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        }
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+
+/* ============= TESTING pqInsertNoCopy ============= */
+static int copies_made = 0;
+
+static PQElementPriority countingCopyInt(PQElementPriority n) {
+    copies_made++;
+    return copyIntGeneric(n);
+}
+
+bool testPQInsertNoCopyTakesOwnership() {
+    bool result = true;
+    PQ pq = pqCreate(countingCopyInt, freeIntGeneric, equalIntsGeneric, countingCopyInt, freeIntGeneric,
+                     compareIntsGeneric);
+    int *elem = NULL;
+    int *prio = NULL;
+    copies_made = 0;
+    for (int i = 0; i < 10; i++) {
+        elem = malloc(sizeof(*elem));
+        prio = malloc(sizeof(*prio));
+        *elem = i;
+        *prio = i;
+        PQHandle handle = NULL;
+        ASSERT_TEST(pqInsertNoCopy(pq, elem, prio, &handle) == PQ_SUCCESS, destroy);
+        int *inserted = elem;
+        elem = NULL;
+        prio = NULL;
+        // the queue holds the very same element
+        ASSERT_TEST(pqGetElementByHandle(pq, handle) == inserted, destroy);
+    }
+    ASSERT_TEST(copies_made == 0, destroy);
+    ASSERT_TEST(*(int *) pqGetFirst(pq) == 9, destroy);
+    ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqGetSize(pq) == 9, destroy);
+
+    int value = 3;
+    ASSERT_TEST(pqInsertNoCopy(pq, &value, NULL, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqInsertNoCopy(NULL, &value, &value, NULL) == PQ_NULL_ARGUMENT, destroy);
+
+    destroy:
+    free(elem);
+    free(prio);
+    pqDestroy(pq);
+    return result;
+}
+
+
+/* ============= TESTING pqPopFirst and pqPopWhile ============= */
+static bool priorityAtLeast(PQElement element, PQElementPriority priority, void *threshold) {
+    return *(int *) priority >= *(int *) threshold;
+}
+
+bool testPQPopFirstHandsOverTheElement() {
+    bool result = true;
+    PQ pq = createPQ();
+    PQElement element = NULL;
+    PQElementPriority priority = NULL;
+    ASSERT_TEST(pqPopFirst(NULL, &element, &priority) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqPopFirst(pq, &element, &priority) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    for (int i = 0; i < 5; i++) {
+        int prio = i * 10;
+        ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqPopFirst(pq, &element, &priority) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(*(int *) element == 4 && *(int *) priority == 40, destroy);
+    ASSERT_TEST(pqGetSize(pq) == 4, destroy);
+    // NULL outputs free what they would have received
+    ASSERT_TEST(pqPopFirst(pq, NULL, NULL) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(*(int *) pqGetFirst(pq) == 2, destroy);
+
+    destroy:
+    free(element);
+    free(priority);
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQPopWhileDrainsMatchingHeadInOrder() {
+    bool result = true;
+    PQ pq = NULL;
+    PQElement elements[10] = {NULL};
+    PQElementPriority priorities[10] = {NULL};
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        for (int i = 0; i < 20; i++) {
+            int prio = i % 10;
+            ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+        }
+        int threshold = 6;
+        ASSERT_TEST(pqPopWhile(NULL, priorityAtLeast, &threshold, elements, NULL, 10) == -1, destroy);
+        ASSERT_TEST(pqPopWhile(pq, NULL, &threshold, elements, NULL, 10) == -1, destroy);
+        // eight elements have a priority of at least 6, at most five are popped at once
+        ASSERT_TEST(pqPopWhile(pq, priorityAtLeast, &threshold, elements, priorities, 5) == 5, destroy);
+        int expected[] = {9, 19, 8, 18, 7};
+        for (int i = 0; i < 5; i++) {
+            ASSERT_TEST(*(int *) elements[i] == expected[i], destroy);
+            ASSERT_TEST(*(int *) priorities[i] == expected[i] % 10, destroy);
+            free(elements[i]);
+            free(priorities[i]);
+            elements[i] = NULL;
+            priorities[i] = NULL;
+        }
+        ASSERT_TEST(pqPopWhile(pq, priorityAtLeast, &threshold, elements, NULL, 10) == 3, destroy);
+        ASSERT_TEST(*(int *) elements[0] == 17 && *(int *) elements[2] == 16, destroy);
+        for (int i = 0; i < 3; i++) {
+            free(elements[i]);
+            elements[i] = NULL;
+        }
+        ASSERT_TEST(pqPopWhile(pq, priorityAtLeast, &threshold, elements, NULL, 10) == 0, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 12, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    for (int i = 0; i < 10; i++) {
+        free(elements[i]);
+        free(priorities[i]);
+    }
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqInsertBatch ============= */
+bool testPQInsertBatchOrdersAndKeepsTies() {
+    bool result = true;
+    PQ pq = NULL;
+    int values[40], prios[40];
+    PQElement elements[40];
+    PQElementPriority priorities[40];
+    for (int i = 0; i < 40; i++) {
+        values[i] = 100 + i;
+        prios[i] = (i * 7) % 5;
+        elements[i] = &values[i];
+        priorities[i] = &prios[i];
+    }
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        // a few elements already in place, the batch is merged with them
+        for (int i = 0; i < 5; i++) {
+            ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqInsertBatch(pq, elements, priorities, 40) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqInsertBatch(pq, elements, priorities, 0) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 45, destroy);
+        int last_priority = 5;
+        int last_value = -1;
+        int count = 0;
+        PQ_FOREACH(int *, value, pq) {
+            int priority = *value < 100 ? *value : prios[*value - 100];
+            ASSERT_TEST(priority <= last_priority, destroy);
+            // older elements first, then the batch in array order
+            ASSERT_TEST(priority < last_priority || *value > last_value, destroy);
+            last_priority = priority;
+            last_value = *value;
+            count++;
+        }
+        ASSERT_TEST(count == 45, destroy);
+        // a second, smaller batch on top of a bigger queue
+        ASSERT_TEST(pqInsertBatch(pq, elements, priorities, 3) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 48, destroy);
+        for (int i = 0; i < 48; i++) {
+            ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQInsertBatchRejectsNullEntries() {
+    bool result = true;
+    PQ pq = createPQ();
+    int values[] = {1, 2, 3};
+    PQElement elements[] = {&values[0], NULL, &values[2]};
+    PQElementPriority priorities[] = {&values[0], &values[1], &values[2]};
+    ASSERT_TEST(pqInsertBatch(NULL, elements, priorities, 3) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqInsertBatch(pq, NULL, priorities, 3) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqInsertBatch(pq, elements, priorities, 3) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqInsertBatch(pq, elements, priorities, -1) == PQ_ERROR, destroy);
+    ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING insertion order shapes ============= */
+bool testPQInsertMonotoneAndNearlySorted() {
+    bool result = true;
+    PQ pq = NULL;
+    PQHandle handles[60] = {NULL};
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        // descending priorities are appended, the jittered ones land a few nodes from the last insertion
+        for (int i = 0; i < 60; i++) {
+            int prio = i < 30 ? 1000 - i : 1000 - i + (i % 3) * 4;
+            ASSERT_TEST(pqInsertWithHandle(pq, &i, &prio, &handles[i]) == PQ_SUCCESS, destroy);
+            if (i % 7 == 6) {
+                // remove the node inserted last so the next search cannot start from it
+                ASSERT_TEST(pqRemoveByHandle(pq, handles[i]) == PQ_SUCCESS, destroy);
+            }
+        }
+        int i = 5;
+        int prio = 2000;
+        ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == 5, destroy);
+        int last_priority = 2000;
+        int count = 0;
+        PQ_FOREACH(int *, value, pq) {
+            if (count++ == 0) {
+                continue;
+            }
+            int priority = *value < 30 ? 1000 - *value : 1000 - *value + (*value % 3) * 4;
+            ASSERT_TEST(priority <= last_priority, destroy);
+            last_priority = priority;
+        }
+        ASSERT_TEST(count == 60 - 60 / 7 + 1, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING PQCursor ============= */
+bool testPQCursorWalksWithoutTheInternalIterator() {
+    bool result = true;
+    PQ pq = NULL;
+    PQCursor first_cursor, second_cursor;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        ASSERT_TEST(pqCursorBegin(NULL, &first_cursor) == NULL, destroy);
+        ASSERT_TEST(pqCursorBegin(pq, &first_cursor) == NULL, destroy);
+        ASSERT_TEST(pqCursorNext(&first_cursor) == NULL, destroy);
+        ASSERT_TEST(pqCursorNext(NULL) == NULL, destroy);
+        for (int i = 0; i < 10; i++) {
+            int prio = i % 4;
+            ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+        }
+        int expected[] = {3, 7, 2, 6, 1, 5, 9, 0, 4, 8};
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == 3, destroy);
+        // two cursors at different positions, the internal iterator does not move
+        ASSERT_TEST(*(int *) pqCursorBegin(pq, &first_cursor) == 3, destroy);
+        int count = 0;
+        PQ_CURSOR_FOREACH(int *, value, second_cursor, pq) {
+            ASSERT_TEST(*value == expected[count], destroy);
+            if (count % 3 == 0) {
+                PQElement element = pqCursorNext(&first_cursor);
+                ASSERT_TEST(element != NULL && *(int *) element == expected[count / 3 + 1], destroy);
+            }
+            count++;
+        }
+        ASSERT_TEST(count == 10, destroy);
+        ASSERT_TEST(*(int *) pqGetNext(pq) == 7, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQCursorRemoveCurrentKeepsTheCursor() {
+    bool result = true;
+    PQ pq = NULL;
+    PQCursor cursor;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        for (int i = 0; i < 20; i++) {
+            ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqCursorRemoveCurrent(NULL) == PQ_NULL_ARGUMENT, destroy);
+        // remove every even element on the way, including the first and several in a row
+        int expected = 19;
+        PQ_CURSOR_FOREACH(int *, value, cursor, pq) {
+            ASSERT_TEST(*value == expected, destroy);
+            if (*value % 2 == 0 || *value > 15) {
+                ASSERT_TEST(pqCursorRemoveCurrent(&cursor) == PQ_SUCCESS, destroy);
+                ASSERT_TEST(pqCursorRemoveCurrent(&cursor) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+            }
+            expected--;
+        }
+        ASSERT_TEST(expected == -1, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 8, destroy);
+        expected = 15;
+        PQ_FOREACH(int *, value, pq) {
+            ASSERT_TEST(*value == expected, destroy);
+            expected -= 2;
+        }
+        ASSERT_TEST(expected == -1, destroy);
+        // a removal through the cursor right after a fresh begin, then draining everything
+        PQ_CURSOR_FOREACH(int *, value, cursor, pq) {
+            ASSERT_TEST(pqCursorRemoveCurrent(&cursor) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        ASSERT_TEST(pqCursorRemoveCurrent(&cursor) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING PQ_DEFINE ============= */
+typedef struct {
+    int id;
+    char tag;
+} TaggedId;
+
+PQ_DEFINE(TaggedPQ, TaggedId, int, a - b)
+
+bool testTypedPQKeepsTheGenericOrder() {
+    bool result = true;
+    TaggedPQ typed = TaggedPQCreate();
+    PQ pq = createPQ();
+    ASSERT_TEST(typed != NULL, destroy);
+    ASSERT_TEST(TaggedPQInsert(NULL, (TaggedId) {0, 'x'}, 0) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(TaggedPQGetFirst(typed) == NULL && TaggedPQGetSize(NULL) == -1, destroy);
+    ASSERT_TEST(TaggedPQPopFirst(typed, NULL, NULL) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    ASSERT_TEST(TaggedPQRemove(typed) == PQ_SUCCESS, destroy);
+    // the same inputs in both queues come out in the same order
+    for (int i = 0; i < 100; i++) {
+        int prio = (i * 37) % 11;
+        ASSERT_TEST(TaggedPQInsert(typed, (TaggedId) {i, 'a' + i % 26}, prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(TaggedPQGetSize(typed) == 100, destroy);
+    ASSERT_TEST(*TaggedPQGetFirstPriority(typed) == 10, destroy);
+    int count = 0;
+    PQ_FOREACH(int *, value, pq) {
+        TaggedId element;
+        int priority;
+        ASSERT_TEST(TaggedPQGetFirst(typed)->id == *value, destroy);
+        ASSERT_TEST(TaggedPQPopFirst(typed, &element, &priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(element.id == *value && element.tag == 'a' + *value % 26, destroy);
+        ASSERT_TEST(priority == (*value * 37) % 11, destroy);
+        count++;
+    }
+    ASSERT_TEST(count == 100 && TaggedPQGetSize(typed) == 0, destroy);
+    ASSERT_TEST(TaggedPQReserve(typed, 1000) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(TaggedPQInsert(typed, (TaggedId) {1, 'b'}, 1) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(TaggedPQClear(typed) == PQ_SUCCESS && TaggedPQGetSize(typed) == 0, destroy);
+
+    destroy:
+    TaggedPQDestroy(typed);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqCreateInline ============= */
+typedef struct {
+    int id;
+    char name[21];
+    double weight;
+} WideElement;
+
+static bool equalWideElements(PQElement a, PQElement b) {
+    return ((WideElement *) a)->id == ((WideElement *) b)->id;
+}
+
+static unsigned long hashWideElement(PQElement a) {
+    return (unsigned long) ((WideElement *) a)->id;
+}
+
+bool testPQInlineStoresValuesInPlace() {
+    bool result = true;
+    PQ pq = NULL;
+    PQ copy = NULL;
+    ASSERT_TEST(pqCreateInline(0, sizeof(int), PQ_BACKEND_LIST, equalIntsGeneric, NULL,
+                               compareIntsGeneric) == NULL, destroy);
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = pqCreateInline(sizeof(WideElement), sizeof(int), allBackends[b], equalWideElements, hashWideElement,
+                            compareIntsGeneric);
+        ASSERT_TEST(pq != NULL, destroy);
+        for (int i = 0; i < 50; i++) {
+            WideElement element = {i, "", i / 2.0};
+            element.name[0] = (char) ('a' + i % 26);
+            int prio = i % 7;
+            ASSERT_TEST(pqInsert(pq, &element, &prio) == PQ_SUCCESS, destroy);
+        }
+        // the queue holds its own bytes: the locals above are gone and the values are intact
+        WideElement key = {20, "", 0};
+        WideElement *found = pqFind(pq, &key);
+        ASSERT_TEST(found != NULL && found->name[0] == 'u' && found->weight == 10.0, destroy);
+        ASSERT_TEST(((WideElement *) pqGetFirst(pq))->name[0] == 'g' && pqGetSize(pq) == 50, destroy);
+        // changing a priority may pass the element the queue returned
+        int old_prio = 6, new_prio = 100;
+        WideElement *first = pqGetFirst(pq);
+        ASSERT_TEST(pqChangePriority(pq, first, &old_prio, &new_prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(((WideElement *) pqGetFirst(pq))->id == 6, destroy);
+        copy = pqCopy(pq);
+        ASSERT_TEST(copy != NULL && pqGetSize(copy) == 50, destroy);
+        ASSERT_TEST(pqContains(copy, &key), destroy);
+        ASSERT_TEST(pqRemoveElement(copy, &key) == PQ_SUCCESS && !pqContains(copy, &key), destroy);
+        int last_priority = 100;
+        int count = 0;
+        PQ_FOREACH(WideElement *, element, pq) {
+            int priority = element->id == 6 ? 100 : element->id % 7;
+            ASSERT_TEST(priority <= last_priority && element->weight == element->id / 2.0, destroy);
+            last_priority = priority;
+            count++;
+        }
+        ASSERT_TEST(count == 50, destroy);
+        pqDestroy(copy);
+        copy = NULL;
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(copy);
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQInlineHandsOverMallocBlocks() {
+    bool result = true;
+    PQ pq = NULL;
+    int *element = NULL;
+    int *priority = NULL;
+    PQElement popped[5] = {NULL};
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = pqCreateInline(sizeof(int), sizeof(int), allBackends[b], equalIntsGeneric, NULL, compareIntsGeneric);
+        ASSERT_TEST(pq != NULL, destroy);
+        PQHandle handle = NULL;
+        for (int i = 0; i < 10; i++) {
+            element = copyIntGeneric(&i);
+            priority = copyIntGeneric(&i);
+            ASSERT_TEST(element != NULL && priority != NULL, destroy);
+            // the queue copies the bytes and frees the blocks it was handed
+            ASSERT_TEST(pqInsertNoCopy(pq, element, priority, &handle) == PQ_SUCCESS, destroy);
+            element = NULL;
+            priority = NULL;
+        }
+        int new_prio = -1;
+        ASSERT_TEST(pqChangePriorityByHandle(pq, handle, &new_prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*(int *) pqGetElementByHandle(pq, handle) == 9, destroy);
+        PQElement popped_element = NULL;
+        PQElementPriority popped_priority = NULL;
+        ASSERT_TEST(pqPopFirst(pq, &popped_element, &popped_priority) == PQ_SUCCESS, destroy);
+        element = popped_element;
+        priority = popped_priority;
+        ASSERT_TEST(*element == 8 && *priority == 8, destroy);
+        free(element);
+        free(priority);
+        element = NULL;
+        priority = NULL;
+        int threshold = 4;
+        ASSERT_TEST(pqPopWhile(pq, priorityAtLeast, &threshold, popped, NULL, 5) == 4, destroy);
+        for (int i = 0; i < 4; i++) {
+            ASSERT_TEST(*(int *) popped[i] == 7 - i, destroy);
+            free(popped[i]);
+            popped[i] = NULL;
+        }
+        ASSERT_TEST(pqPopFirst(pq, NULL, NULL) == PQ_SUCCESS && pqGetSize(pq) == 4, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    for (int i = 0; i < 5; i++) {
+        free(popped[i]);
+    }
+    free(element);
+    free(priority);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqMerge ============= */
+bool testPQMergeMovesAllAndKeepsTies() {
+    bool result = true;
+    PQ destination = NULL;
+    PQ source = NULL;
+    for (int d = 0; d < NUMBER_BACKENDS; d++) {
+        for (int b = 0; b < NUMBER_BACKENDS; b++) {
+            destination = createHashedPQ(allBackends[d]);
+            source = createPQWithBackend(allBackends[b]);
+            PQHandle handle = NULL;
+            for (int i = 0; i < 30; i++) {
+                int prio = i % 5;
+                ASSERT_TEST(pqInsert(destination, &i, &prio) == PQ_SUCCESS, destroy);
+                int element = 100 + i;
+                ASSERT_TEST(pqInsertWithHandle(source, &element, &prio, &handle) == PQ_SUCCESS, destroy);
+            }
+            ASSERT_TEST(pqMerge(NULL, source) == PQ_NULL_ARGUMENT, destroy);
+            ASSERT_TEST(pqMerge(destination, source) == PQ_SUCCESS, destroy);
+            ASSERT_TEST(pqGetSize(destination) == 60 && pqGetSize(source) == 0, destroy);
+            ASSERT_TEST(pqGetFirst(source) == NULL, destroy);
+            int element = 129;
+            ASSERT_TEST(pqContains(destination, &element), destroy);
+            ASSERT_TEST(pqRemoveByHandle(destination, handle) == PQ_SUCCESS && !pqContains(destination, &element),
+                        destroy);
+            // on equal priorities the destination's elements come first, then the source's, each in insertion order
+            int last_priority = 4;
+            int last_value = -1;
+            int count = 0;
+            PQ_FOREACH(int *, value, destination) {
+                int priority = *value % 100 % 5;
+                ASSERT_TEST(priority < last_priority || (priority == last_priority && *value > last_value), destroy);
+                last_priority = priority;
+                last_value = *value;
+                count++;
+            }
+            ASSERT_TEST(count == 59, destroy);
+            // the source stays usable, and inserting into the destination continues after the merged elements
+            int prio = 4;
+            ASSERT_TEST(pqInsert(source, &element, &prio) == PQ_SUCCESS && pqGetSize(source) == 1, destroy);
+            ASSERT_TEST(pqInsert(destination, &element, &prio) == PQ_SUCCESS, destroy);
+            for (int i = 0; i < 11; i++) {
+                ASSERT_TEST(pqRemove(destination) == PQ_SUCCESS, destroy);
+            }
+            ASSERT_TEST(*(int *) pqGetFirst(destination) == 129, destroy);
+            pqDestroy(source);
+            source = NULL;
+            pqDestroy(destination);
+            destination = NULL;
+        }
+    }
+
+    destroy:
+    pqDestroy(source);
+    pqDestroy(destination);
+    return result;
+}
+
+bool testPQMergeRejectsDifferentQueues() {
+    bool result = true;
+    PQ destination = createPQ();
+    PQ source = pqCreateInline(sizeof(int), sizeof(int), PQ_BACKEND_LIST, equalIntsGeneric, NULL,
+                               compareIntsGeneric);
+    ASSERT_TEST(destination != NULL && source != NULL, destroy);
+    int value = 1;
+    ASSERT_TEST(pqInsert(source, &value, &value) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqMerge(destination, source) == PQ_ERROR, destroy);
+    ASSERT_TEST(pqMerge(source, source) == PQ_SUCCESS && pqGetSize(source) == 1, destroy);
+    ASSERT_TEST(pqGetSize(destination) == 0, destroy);
+
+    destroy:
+    pqDestroy(source);
+    pqDestroy(destination);
+    return result;
+}
+
+/* ============= TESTING pqPeekTopK and pqToSortedArray ============= */
+bool testPQPeekTopKLeavesTheQueueAlone() {
+    bool result = true;
+    PQ pq = NULL;
+    PQElement elements[20];
+    PQElementPriority priorities[20];
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        ASSERT_TEST(pqPeekTopK(NULL, 5, elements, NULL) == -1, destroy);
+        ASSERT_TEST(pqPeekTopK(pq, 5, elements, NULL) == 0, destroy);
+        for (int i = 0; i < 100; i++) {
+            int prio = (i * 31) % 17;
+            ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+        }
+        // some removals, so the heaps are not in insertion shape
+        for (int i = 0; i < 10; i++) {
+            ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqPeekTopK(pq, 20, elements, priorities) == 20, destroy);
+        int count = 0;
+        PQ_FOREACH(int *, value, pq) {
+            if (count < 20) {
+                ASSERT_TEST(elements[count] == value, destroy);
+                ASSERT_TEST(*(int *) priorities[count] == (*value * 31) % 17, destroy);
+            }
+            count++;
+        }
+        ASSERT_TEST(count == 90, destroy);
+        ASSERT_TEST(pqPeekTopK(pq, 0, elements, priorities) == 0, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQToSortedArrayKeepsTheIterator() {
+    bool result = true;
+    PQ pq = NULL;
+    PQElement *elements = NULL;
+    PQElementPriority *priorities = NULL;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        ASSERT_TEST(pqToSortedArray(pq, NULL, NULL) == -1, destroy);
+        ASSERT_TEST(pqToSortedArray(pq, &elements, NULL) == 0, destroy);
+        free(elements);
+        elements = NULL;
+        for (int i = 0; i < 50; i++) {
+            int prio = i % 6;
+            ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+        }
+        // the internal iterator is in the middle of the queue and stays there
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == 5, destroy);
+        ASSERT_TEST(*(int *) pqGetNext(pq) == 11, destroy);
+        ASSERT_TEST(pqToSortedArray(pq, &elements, &priorities) == 50, destroy);
+        ASSERT_TEST(*(int *) pqGetNext(pq) == 17, destroy);
+        for (int i = 0; i < 50; i++) {
+            ASSERT_TEST(*(int *) priorities[i] == *(int *) elements[i] % 6, destroy);
+            if (i > 0) {
+                int previous = *(int *) elements[i - 1];
+                int current = *(int *) elements[i];
+                ASSERT_TEST(previous % 6 > current % 6 || (previous % 6 == current % 6 && previous < current),
+                            destroy);
+            }
+        }
+        free(elements);
+        free(priorities);
+        elements = NULL;
+        priorities = NULL;
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    free(elements);
+    free(priorities);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqGetLast, pqRemoveLast and pqCreateBounded ============= */
+bool testPQRemoveLastFollowsTheOrderBackwards() {
+    bool result = true;
+    PQ pq = NULL;
+    PQElement *elements = NULL;
+    int expected[150];
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        ASSERT_TEST(pqGetLast(NULL) == NULL, destroy);
+        ASSERT_TEST(pqRemoveLast(NULL) == PQ_NULL_ARGUMENT, destroy);
+        ASSERT_TEST(pqGetLast(pq) == NULL, destroy);
+        ASSERT_TEST(pqRemoveLast(pq) == PQ_SUCCESS, destroy);
+        for (int i = 0; i < 200; i++) {
+            int prio = (i * 37) % 23;
+            ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+            if (i % 4 == 3) {
+                ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+            }
+        }
+        ASSERT_TEST(pqToSortedArray(pq, &elements, NULL) == 150, destroy);
+        for (int i = 0; i < 150; i++) {
+            expected[i] = *(int *) elements[i];
+        }
+        free(elements);
+        elements = NULL;
+        // removing from both ends meets in the middle
+        for (int low = 149, high = 0; low >= high; low--) {
+            ASSERT_TEST(*(int *) pqGetLast(pq) == expected[low], destroy);
+            ASSERT_TEST(pqRemoveLast(pq) == PQ_SUCCESS, destroy);
+            if (low % 3 == 0 && low > high) {
+                ASSERT_TEST(*(int *) pqGetFirst(pq) == expected[high], destroy);
+                ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+                high++;
+            }
+        }
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        ASSERT_TEST(pqGetLast(pq) == NULL, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    free(elements);
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQBoundedDropsTheLowest() {
+    bool result = true;
+    PQ pq = NULL;
+    PQ other = NULL;
+    PQElement batch_elements[3];
+    PQElementPriority batch_priorities[3];
+    int batch[] = {50, 51, 52};
+    int batch_prio[] = {20, 0, 7};
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        ASSERT_TEST(pqCreateBounded(0, allBackends[b], copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                                    copyIntGeneric, freeIntGeneric, compareIntsGeneric) == NULL, destroy);
+        pq = pqCreateBounded(5, allBackends[b], copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                             copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+        ASSERT_TEST(pq != NULL, destroy);
+        for (int i = 0; i < 10; i++) {
+            ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+            ASSERT_TEST(pqGetSize(pq) == (i < 5 ? i + 1 : 5), destroy);
+        }
+        ASSERT_TEST(*(int *) pqGetLast(pq) == 5, destroy);
+        // too low, and equal to the last one but inserted later: both are dropped right away
+        PQHandle handle = NULL;
+        int elem = 100, prio = 3;
+        ASSERT_TEST(pqInsertWithHandle(pq, &elem, &prio, &handle) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(handle == NULL, destroy);
+        prio = 5;
+        ASSERT_TEST(pqInsertWithHandle(pq, &elem, &prio, &handle) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(handle == NULL, destroy);
+        ASSERT_TEST(!pqContains(pq, &elem), destroy);
+        // a higher one pushes the lowest out
+        prio = 8;
+        ASSERT_TEST(pqInsertWithHandle(pq, &elem, &prio, &handle) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(handle != NULL && *(int *) pqGetElementByHandle(pq, handle) == 100, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 5, destroy);
+        ASSERT_TEST(*(int *) pqGetLast(pq) == 6, destroy);
+        // batches and merges are trimmed as a whole
+        for (int i = 0; i < 3; i++) {
+            batch_elements[i] = &batch[i];
+            batch_priorities[i] = &batch_prio[i];
+        }
+        ASSERT_TEST(pqInsertBatch(pq, batch_elements, batch_priorities, 3) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 5, destroy);
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == 50, destroy);
+        ASSERT_TEST(*(int *) pqGetLast(pq) == 7, destroy);
+        other = createPQWithBackend(allBackends[b]);
+        for (int i = 0; i < 4; i++) {
+            int other_prio = 30 + i;
+            ASSERT_TEST(pqInsert(other, &i, &other_prio) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqMerge(pq, other) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 5, destroy);
+        ASSERT_TEST(*(int *) pqGetLast(pq) == 50, destroy);
+        pqDestroy(other);
+        other = NULL;
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(other);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING the concurrent priority queue ============= */
+bool testConcurrentPQPopsInOrder() {
+    bool result = true;
+    ConcurrentPriorityQueue cpq = cpqCreate(copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric,
+                                            compareIntsGeneric);
+    ASSERT_TEST(cpq != NULL, destroy);
+    ASSERT_TEST(cpqCreate(copyIntGeneric, NULL, copyIntGeneric, freeIntGeneric, compareIntsGeneric) == NULL,
+                destroy);
+    int elem = 1;
+    ASSERT_TEST(cpqInsert(NULL, &elem, &elem) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(cpqInsert(cpq, &elem, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(cpqPopFirst(NULL, NULL, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(cpqPopFirst(cpq, NULL, NULL) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    ASSERT_TEST(cpqGetSize(NULL) == -1, destroy);
+    // more than the first segment holds
+    for (int i = 0; i < 300; i++) {
+        int prio = (i * 13) % 7;
+        ASSERT_TEST(cpqInsert(cpq, &i, &prio) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(cpqGetSize(cpq) == 300, destroy);
+    int previous = -1;
+    for (int i = 0; i < 250; i++) {
+        PQElement popped = NULL;
+        PQElementPriority prio = NULL;
+        ASSERT_TEST(cpqPopFirst(cpq, &popped, &prio) == PQ_SUCCESS, destroy);
+        int value = *(int *) popped;
+        bool in_order = *(int *) prio == (value * 13) % 7 &&
+                        (previous < 0 || (previous * 13) % 7 > *(int *) prio ||
+                         ((previous * 13) % 7 == *(int *) prio && previous < value));
+        previous = value;
+        free(popped);
+        free(prio);
+        ASSERT_TEST(in_order, destroy);
+    }
+    ASSERT_TEST(cpqGetSize(cpq) == 50, destroy);
+
+    destroy:
+    cpqDestroy(cpq);
+    return result;
+}
+
+#define CONCURRENT_THREADS 4
+#define CONCURRENT_ELEMENTS_PER_THREAD 3000
+
+typedef struct {
+    ConcurrentPriorityQueue cpq;
+    MultiPriorityQueue mpq;  // used instead of cpq when it is not NULL
+    int first_value;       // producers insert first_value and on
+    int count;
+    int *popped;           // consumers record the values they pop, in order
+    bool failed;
+} ConcurrentTestThread;
+
+static int concurrentTestPriority(int value) {
+    return (value * 7919) % 1000;
+}
+
+static void *concurrentTestProducer(void *argument) {
+    ConcurrentTestThread *thread = argument;
+    for (int i = 0; i < thread->count; i++) {
+        int value = thread->first_value + i;
+        int prio = concurrentTestPriority(value);
+        PriorityQueueResult insert_result = thread->mpq != NULL ? mpqInsert(thread->mpq, &value, &prio)
+                                                                : cpqInsert(thread->cpq, &value, &prio);
+        if (insert_result != PQ_SUCCESS) {
+            thread->failed = true;
+        }
+    }
+    return NULL;
+}
+
+static void *concurrentTestConsumer(void *argument) {
+    ConcurrentTestThread *thread = argument;
+    int popped = 0;
+    while (popped < thread->count) {
+        PQElement element = NULL;
+        PriorityQueueResult pop_result = thread->mpq != NULL ? mpqPopFirst(thread->mpq, &element, NULL)
+                                                             : cpqPopFirst(thread->cpq, &element, NULL);
+        if (pop_result == PQ_ELEMENT_DOES_NOT_EXISTS) {
+            continue; // the producers are not done yet
+        }
+        if (pop_result != PQ_SUCCESS) {
+            thread->failed = true;
+            return NULL;
+        }
+        thread->popped[popped++] = *(int *) element;
+        free(element);
+    }
+    return NULL;
+}
+
+// runs the threads, producers first in the array, and joins them all
+static bool runConcurrentTestThreads(ConcurrentTestThread *threads, int producers, int consumers) {
+    pthread_t ids[2 * CONCURRENT_THREADS];
+    for (int i = 0; i < producers + consumers; i++) {
+        if (pthread_create(&ids[i], NULL, i < producers ? concurrentTestProducer : concurrentTestConsumer,
+                           &threads[i]) != 0) {
+            while (i-- > 0) {
+                pthread_join(ids[i], NULL);
+            }
+            return false;
+        }
+    }
+    bool ok = true;
+    for (int i = 0; i < producers + consumers; i++) {
+        pthread_join(ids[i], NULL);
+        ok = ok && !threads[i].failed;
+    }
+    return ok;
+}
+
+bool testConcurrentPQManyThreads() {
+    bool result = true;
+    const int total = CONCURRENT_THREADS * CONCURRENT_ELEMENTS_PER_THREAD;
+    ConcurrentTestThread threads[2 * CONCURRENT_THREADS];
+    int *popped = malloc(sizeof(*popped) * total);
+    int *seen = calloc(total, sizeof(*seen));
+    ConcurrentPriorityQueue cpq = cpqCreate(copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric,
+                                            compareIntsGeneric);
+    ASSERT_TEST(popped != NULL && seen != NULL && cpq != NULL, destroy);
+    for (int i = 0; i < 2 * CONCURRENT_THREADS; i++) {
+        threads[i].cpq = cpq;
+        threads[i].mpq = NULL;
+        threads[i].first_value = (i % CONCURRENT_THREADS) * CONCURRENT_ELEMENTS_PER_THREAD;
+        threads[i].count = CONCURRENT_ELEMENTS_PER_THREAD;
+        threads[i].popped = popped + (i % CONCURRENT_THREADS) * CONCURRENT_ELEMENTS_PER_THREAD;
+        threads[i].failed = false;
+    }
+
+    // all the threads insert at once, then all of them pop at once. Without insertions going on,
+    // every pop returns the first element, so what each thread pops is in order
+    ASSERT_TEST(runConcurrentTestThreads(threads, CONCURRENT_THREADS, 0), destroy);
+    ASSERT_TEST(cpqGetSize(cpq) == total, destroy);
+    ASSERT_TEST(runConcurrentTestThreads(threads, 0, CONCURRENT_THREADS), destroy);
+    ASSERT_TEST(cpqGetSize(cpq) == 0, destroy);
+    for (int t = 0; t < CONCURRENT_THREADS; t++) {
+        for (int i = 1; i < CONCURRENT_ELEMENTS_PER_THREAD; i++) {
+            int previous = threads[t].popped[i - 1];
+            int current = threads[t].popped[i];
+            ASSERT_TEST(concurrentTestPriority(previous) > concurrentTestPriority(current) ||
+                        (concurrentTestPriority(previous) == concurrentTestPriority(current) &&
+                         (previous < current || previous / CONCURRENT_ELEMENTS_PER_THREAD !=
+                                                current / CONCURRENT_ELEMENTS_PER_THREAD)), destroy);
+        }
+    }
+    for (int i = 0; i < total; i++) {
+        seen[popped[i]]++;
+    }
+    for (int i = 0; i < total; i++) {
+        ASSERT_TEST(seen[i] == 1, destroy);
+        seen[i] = 0;
+    }
+
+    // producers and consumers at the same time
+    ASSERT_TEST(runConcurrentTestThreads(threads, CONCURRENT_THREADS, CONCURRENT_THREADS), destroy);
+    ASSERT_TEST(cpqGetSize(cpq) == 0, destroy);
+    for (int i = 0; i < total; i++) {
+        seen[popped[i]]++;
+    }
+    for (int i = 0; i < total; i++) {
+        ASSERT_TEST(seen[i] == 1, destroy);
+    }
+
+    destroy:
+    free(popped);
+    free(seen);
+    cpqDestroy(cpq);
+    return result;
+}
+
+/* ============= TESTING the multi priority queue ============= */
+bool testMultiPQPopsEveryElementOnce() {
+    bool result = true;
+    MultiPriorityQueue exact = mpqCreate(1, copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric,
+                                         compareIntsGeneric);
+    MultiPriorityQueue relaxed = mpqCreate(8, copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric,
+                                           compareIntsGeneric);
+    int seen[500] = {0};
+    ASSERT_TEST(exact != NULL && relaxed != NULL, destroy);
+    ASSERT_TEST(mpqCreate(0, copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric,
+                          compareIntsGeneric) == NULL, destroy);
+    int elem = 1;
+    ASSERT_TEST(mpqInsert(NULL, &elem, &elem) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(mpqInsert(relaxed, NULL, &elem) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(mpqPopFirst(NULL, NULL, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(mpqPopFirst(relaxed, NULL, NULL) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    ASSERT_TEST(mpqRemove(relaxed) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(mpqGetSize(NULL) == -1, destroy);
+    for (int i = 0; i < 500; i++) {
+        int prio = i % 10;
+        ASSERT_TEST(mpqInsert(exact, &i, &prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(mpqInsert(relaxed, &i, &prio) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(mpqGetSize(relaxed) == 500, destroy);
+    // one internal queue keeps the exact order
+    for (int i = 0; i < 500; i++) {
+        PQElement popped = NULL;
+        ASSERT_TEST(mpqPopFirst(exact, &popped, NULL) == PQ_SUCCESS, destroy);
+        int value = *(int *) popped;
+        free(popped);
+        ASSERT_TEST(value == 9 - i / 50 + 10 * (i % 50), destroy);
+    }
+    for (int i = 0; i < 500; i++) {
+        PQElement popped = NULL;
+        PQElementPriority prio = NULL;
+        ASSERT_TEST(mpqPopFirst(relaxed, &popped, &prio) == PQ_SUCCESS, destroy);
+        int value = *(int *) popped;
+        bool matches = *(int *) prio == value % 10;
+        free(popped);
+        free(prio);
+        ASSERT_TEST(matches, destroy);
+        seen[value]++;
+    }
+    for (int i = 0; i < 500; i++) {
+        ASSERT_TEST(seen[i] == 1, destroy);
+    }
+    ASSERT_TEST(mpqPopFirst(relaxed, NULL, NULL) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+
+    destroy:
+    mpqDestroy(exact);
+    mpqDestroy(relaxed);
+    return result;
+}
+
+bool testMultiPQManyThreads() {
+    bool result = true;
+    const int total = CONCURRENT_THREADS * CONCURRENT_ELEMENTS_PER_THREAD;
+    ConcurrentTestThread threads[2 * CONCURRENT_THREADS];
+    int *popped = malloc(sizeof(*popped) * total);
+    int *seen = calloc(total, sizeof(*seen));
+    MultiPriorityQueue mpq = mpqCreate(2 * CONCURRENT_THREADS, copyIntGeneric, freeIntGeneric, copyIntGeneric,
+                                       freeIntGeneric, compareIntsGeneric);
+    ASSERT_TEST(popped != NULL && seen != NULL && mpq != NULL, destroy);
+    for (int i = 0; i < 2 * CONCURRENT_THREADS; i++) {
+        threads[i].cpq = NULL;
+        threads[i].mpq = mpq;
+        threads[i].first_value = (i % CONCURRENT_THREADS) * CONCURRENT_ELEMENTS_PER_THREAD;
+        threads[i].count = CONCURRENT_ELEMENTS_PER_THREAD;
+        threads[i].popped = popped + (i % CONCURRENT_THREADS) * CONCURRENT_ELEMENTS_PER_THREAD;
+        threads[i].failed = false;
+    }
+    ASSERT_TEST(runConcurrentTestThreads(threads, CONCURRENT_THREADS, CONCURRENT_THREADS), destroy);
+    ASSERT_TEST(mpqGetSize(mpq) == 0, destroy);
+    for (int i = 0; i < total; i++) {
+        seen[popped[i]]++;
+    }
+    for (int i = 0; i < total; i++) {
+        ASSERT_TEST(seen[i] == 1, destroy);
+    }
+
+    destroy:
+    free(popped);
+    free(seen);
+    mpqDestroy(mpq);
+    return result;
+}
+
+/* ============= TESTING the blocking priority queue ============= */
+// a priority is ready once it is at least the threshold, which another thread may lower
+typedef struct {
+    pthread_mutex_t lock;
+    int threshold;
+} ReadyThreshold;
+
+static bool isAboveThreshold(PQElement element, PQElementPriority priority, void *context) {
+    ReadyThreshold *ready = context;
+    pthread_mutex_lock(&ready->lock);
+    bool above = *(int *) priority >= ready->threshold;
+    pthread_mutex_unlock(&ready->lock);
+    return above;
+}
+
+static void setThreshold(ReadyThreshold *ready, int threshold) {
+    pthread_mutex_lock(&ready->lock);
+    ready->threshold = threshold;
+    pthread_mutex_unlock(&ready->lock);
+}
+
+bool testBlockingPQPopsOnlyReadyElements() {
+    bool result = true;
+    ReadyThreshold ready = {PTHREAD_MUTEX_INITIALIZER, 10};
+    PQ pq = createPQ();
+    BlockingPriorityQueue bpq = bpqCreate(pq, isAboveThreshold, &ready);
+    ASSERT_TEST(bpq != NULL, destroy);
+    ASSERT_TEST(bpqCreate(NULL, NULL, NULL) == NULL, destroy);
+    ASSERT_TEST(bpqPopWait(NULL, 0, NULL, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(bpqInsert(NULL, &ready.threshold, &ready.threshold) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(bpqWakeWaiters(NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(bpqGetSize(NULL) == -1, destroy);
+    ASSERT_TEST(bpqPopWait(bpq, 0, NULL, NULL) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    int elem = 1, prio = 5;
+    ASSERT_TEST(bpqInsert(bpq, &elem, &prio) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(bpqPopWait(bpq, 0, NULL, NULL) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    ASSERT_TEST(bpqPopWait(bpq, 20, NULL, NULL) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    ASSERT_TEST(bpqGetSize(bpq) == 1, destroy);
+    setThreshold(&ready, 5);
+    PQElement popped = NULL;
+    PQElementPriority popped_prio = NULL;
+    ASSERT_TEST(bpqPopWait(bpq, 0, &popped, &popped_prio) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(*(int *) popped == 1 && *(int *) popped_prio == 5, destroy);
+    free(popped);
+    free(popped_prio);
+    ASSERT_TEST(bpqGetSize(bpq) == 0, destroy);
+
+    destroy:
+    if (bpq == NULL) {
+        pqDestroy(pq);
+    }
+    bpqDestroy(bpq);
+    return result;
+}
+
+#define BLOCKING_TEST_POPS 3
+
+typedef struct {
+    BlockingPriorityQueue bpq;
+    int popped[BLOCKING_TEST_POPS];
+    bool failed;
+} BlockingTestConsumer;
+
+static void *blockingTestConsumer(void *argument) {
+    BlockingTestConsumer *consumer = argument;
+    for (int i = 0; i < BLOCKING_TEST_POPS; i++) {
+        PQElement element = NULL;
+        if (bpqPopWait(consumer->bpq, -1, &element, NULL) != PQ_SUCCESS) {
+            consumer->failed = true;
+            return NULL;
+        }
+        consumer->popped[i] = *(int *) element;
+        free(element);
+    }
+    return NULL;
+}
+
+// waits until the consumer popped down to size elements
+static void waitForSize(BlockingPriorityQueue bpq, int size) {
+    while (bpqGetSize(bpq) != size) {
+        sched_yield();
+    }
+}
+
+bool testBlockingPQWakesWaitingConsumer() {
+    bool result = true;
+    ReadyThreshold ready = {PTHREAD_MUTEX_INITIALIZER, 5};
+    PQ pq = createPQ();
+    BlockingTestConsumer consumer = {bpqCreate(pq, isAboveThreshold, &ready), {0}, false};
+    pthread_t id;
+    bool started = false;
+    ASSERT_TEST(consumer.bpq != NULL, destroy);
+    ASSERT_TEST(pthread_create(&id, NULL, blockingTestConsumer, &consumer) == 0, destroy);
+    started = true;
+    // not ready, then a ready one in front of it
+    int elem = 1, prio = 1;
+    ASSERT_TEST(bpqInsert(consumer.bpq, &elem, &prio) == PQ_SUCCESS, destroy);
+    elem = 2;
+    prio = 7;
+    ASSERT_TEST(bpqInsert(consumer.bpq, &elem, &prio) == PQ_SUCCESS, destroy);
+    waitForSize(consumer.bpq, 1);
+    // the first element becomes ready without any insertion
+    setThreshold(&ready, 0);
+    ASSERT_TEST(bpqWakeWaiters(consumer.bpq) == PQ_SUCCESS, destroy);
+    waitForSize(consumer.bpq, 0);
+    elem = 3;
+    prio = 3;
+    ASSERT_TEST(bpqInsert(consumer.bpq, &elem, &prio) == PQ_SUCCESS, destroy);
+    pthread_join(id, NULL);
+    started = false;
+    ASSERT_TEST(!consumer.failed, destroy);
+    ASSERT_TEST(consumer.popped[0] == 2 && consumer.popped[1] == 1 && consumer.popped[2] == 3, destroy);
+
+    destroy:
+    if (started) {
+        // let a consumer that is still waiting finish
+        setThreshold(&ready, 0);
+        for (int i = 0; i < BLOCKING_TEST_POPS; i++) {
+            bpqInsert(consumer.bpq, &elem, &prio);
+        }
+        pthread_join(id, NULL);
+    }
+    if (consumer.bpq == NULL) {
+        pqDestroy(pq);
+    }
+    bpqDestroy(consumer.bpq);
+    return result;
+}
+
+/* ============= TESTING pqSetLazyRemoval ============= */
+bool testPQLazyRemovalSkipsRemovedElements() {
+    bool result = true;
+    PQ pq = NULL;
+    PQ copy = NULL;
+    PQHandle handles[10];
+    PQElement elements[10];
+    int removed[] = {9, 7, 5, 3, 1, 0};
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createPQWithBackend(allBackends[b]);
+        ASSERT_TEST(pqSetLazyRemoval(NULL, 0.5) == PQ_NULL_ARGUMENT, destroy);
+        ASSERT_TEST(pqSetLazyRemoval(pq, 1.5) == PQ_ERROR, destroy);
+        // 1 never compacts, the removed nodes stay until they reach an end of the queue
+        ASSERT_TEST(pqSetLazyRemoval(pq, 1) == PQ_SUCCESS, destroy);
+        for (int i = 0; i < 10; i++) {
+            ASSERT_TEST(pqInsertWithHandle(pq, &i, &i, &handles[i]) == PQ_SUCCESS, destroy);
+        }
+        for (int i = 0; i < 6; i++) {
+            ASSERT_TEST(pqRemoveByHandle(pq, handles[removed[i]]) == PQ_SUCCESS, destroy);
+        }
+        ASSERT_TEST(pqGetSize(pq) == 4, destroy);
+        ASSERT_TEST(!pqContains(pq, &removed[1]), destroy);
+        int expected = 8;
+        PQ_FOREACH(int *, element, pq) {
+            ASSERT_TEST(*element == expected, destroy);
+            // reading the ends leaves the removed nodes there, so the iteration goes on
+            PQCursor cursor;
+            ASSERT_TEST(*(int *) pqGetLast(pq) == 2, destroy);
+            ASSERT_TEST(*(int *) pqCursorBegin(pq, &cursor) == 8, destroy);
+            expected -= 2;
+        }
+        ASSERT_TEST(expected == 0, destroy);
+        ASSERT_TEST(pqPeekTopK(pq, 10, elements, NULL) == 4, destroy);
+        ASSERT_TEST(*(int *) elements[0] == 8 && *(int *) elements[3] == 2, destroy);
+        ASSERT_TEST(*(int *) pqGetLast(pq) == 2, destroy);
+        copy = pqCopy(pq);
+        ASSERT_TEST(copy != NULL && pqGetSize(copy) == 4 && *(int *) pqGetFirst(copy) == 8, destroy);
+        ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+        PQElement first = NULL;
+        ASSERT_TEST(pqPopFirst(pq, &first, NULL) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*(int *) first == 6, destroy);
+        freeIntGeneric(first);
+        ASSERT_TEST(pqGetSize(pq) == 2, destroy);
+        pqDestroy(copy);
+        copy = NULL;
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(copy);
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQLazyRemovalCompacts() {
+    bool result = true;
+    PQ pq = NULL;
+    for (int b = 0; b < NUMBER_BACKENDS; b++) {
+        pq = createHashedPQ(allBackends[b]);
+        ASSERT_TEST(pqSetLazyRemoval(pq, 0.25) == PQ_SUCCESS, destroy);
+        for (int i = 0; i < 100; i++) {
+            ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+        }
+        for (int i = 0; i < 100; i++) {
+            if (i % 3 != 0) {
+                ASSERT_TEST(pqRemoveElement(pq, &i) == PQ_SUCCESS, destroy);
+                ASSERT_TEST(pqRemoveElement(pq, &i) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+            }
+        }
+        ASSERT_TEST(pqGetSize(pq) == 34, destroy);
+        int elem = 1, prio = 1000;
+        ASSERT_TEST(!pqContains(pq, &elem), destroy);
+        ASSERT_TEST(pqInsert(pq, &elem, &prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == 1, destroy);
+        // back to eager removal, what is left is compacted and still in order
+        ASSERT_TEST(pqSetLazyRemoval(pq, 0) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqRemoveElement(pq, &elem) == PQ_SUCCESS, destroy);
+        for (int expected = 99; expected >= 0; expected -= 3) {
+            PQElement first = NULL;
+            ASSERT_TEST(pqPopFirst(pq, &first, NULL) == PQ_SUCCESS, destroy);
+            int value = *(int *) first;
+            freeIntGeneric(first);
+            ASSERT_TEST(value == expected, destroy);
+        }
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING PQ_BACKEND_SKIPLIST ============= */
+bool testPQSkiplistKeepsTheOrderUnderChurn() {
+    bool result = true;
+    PQ skiplist = createHashedPQ(PQ_BACKEND_SKIPLIST);
+    PQ list = createHashedPQ(PQ_BACKEND_LIST);
+    int priorities[1000];
+    ASSERT_TEST(skiplist != NULL && list != NULL, destroy);
+    for (int i = 0; i < 1000; i++) {
+        priorities[i] = -1;
+    }
+    srand(19);
+    // elements are distinct, priorities repeat so the insertion order matters too
+    for (int step = 0; step < 5000; step++) {
+        int elem = rand() % 1000;
+        int prio = rand() % 100;
+        PQ pqs[] = {skiplist, list};
+        for (int i = 0; i < 2; i++) {
+            if (priorities[elem] < 0) {
+                ASSERT_TEST(pqInsert(pqs[i], &elem, &prio) == PQ_SUCCESS, destroy);
+            } else if (step % 2 == 0) {
+                ASSERT_TEST(pqRemoveElement(pqs[i], &elem) == PQ_SUCCESS, destroy);
+            } else {
+                ASSERT_TEST(pqChangePriority(pqs[i], &elem, &priorities[elem], &prio) == PQ_SUCCESS, destroy);
+            }
+        }
+        priorities[elem] = priorities[elem] >= 0 && step % 2 == 0 ? -1 : prio;
+        if (step % 7 == 0) {
+            PQElement first = NULL;
+            ASSERT_TEST(pqPopFirst(skiplist, &first, NULL) == PQ_SUCCESS, destroy);
+            priorities[*(int *) first] = -1;
+            freeIntGeneric(first);
+            ASSERT_TEST(pqRemove(list) == PQ_SUCCESS, destroy);
+        }
+    }
+    ASSERT_TEST(pqGetSize(skiplist) == pqGetSize(list), destroy);
+    int *expected = pqGetFirst(list);
+    PQ_FOREACH(int *, current, skiplist) {
+        ASSERT_TEST(expected != NULL && *current == *expected, destroy);
+        expected = pqGetNext(list);
+    }
+    ASSERT_TEST(expected == NULL, destroy);
+    ASSERT_TEST(*(int *) pqGetLast(skiplist) == *(int *) pqGetLast(list), destroy);
+
+    destroy:
+    pqDestroy(skiplist);
+    pqDestroy(list);
+    return result;
+}
+
+
+/* ============= TESTING PQ_BACKEND_RADIX_HEAP and PQ_BACKEND_CALENDAR_QUEUE ============= */
+const PQBackend keyedBackends[] = {PQ_BACKEND_RADIX_HEAP, PQ_BACKEND_CALENDAR_QUEUE};
+#define NUMBER_KEYED_BACKENDS (int) (sizeof(keyedBackends) / sizeof(*keyedBackends))
+
+// the tests order higher ints first, so they come first with smaller keys
+static long intKeyGeneric(PQElementPriority n) {
+    return -(long) *(int *) n;
+}
+
+PriorityQueue createKeyedPQ(PQBackend backend) {
+    return pqCreateKeyed(backend, copyIntGeneric, freeIntGeneric, equalIntsGeneric, hashIntGeneric,
+                         copyIntGeneric, freeIntGeneric, compareIntsGeneric, intKeyGeneric);
+}
+
+bool testPQKeyedBackendsNeedKeys() {
+    bool result = true;
+    PQ unkeyed = NULL;
+    PQ keyed = NULL;
+    for (int b = 0; b < NUMBER_KEYED_BACKENDS; b++) {
+        unkeyed = pqCreateWithBackend(keyedBackends[b], copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                                      copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+        keyed = pqCreateKeyed(keyedBackends[b], copyIntGeneric, freeIntGeneric, equalIntsGeneric, NULL,
+                              copyIntGeneric, freeIntGeneric, compareIntsGeneric, NULL);
+        ASSERT_TEST(unkeyed == NULL, destroy);
+        ASSERT_TEST(keyed == NULL, destroy);
+    }
+    // other backends take the keys and ignore them
+    keyed = createKeyedPQ(PQ_BACKEND_LIST);
+    ASSERT_TEST(keyed != NULL, destroy);
+    int elem = 1, prio = 2;
+    ASSERT_TEST(pqInsert(keyed, &elem, &prio) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(*(int *) pqGetFirst(keyed) == 1, destroy);
+
+    destroy:
+    pqDestroy(unkeyed);
+    pqDestroy(keyed);
+    return result;
+}
+
+bool testPQKeyedBackendsKeepTheOrderUnderChurn() {
+    bool result = true;
+    PQ keyed = NULL;
+    PQ list = NULL;
+    PQ copy = NULL;
+    for (int b = 0; b < NUMBER_KEYED_BACKENDS; b++) {
+        keyed = createKeyedPQ(keyedBackends[b]);
+        list = createHashedPQ(PQ_BACKEND_LIST);
+        int priorities[1000];
+        bool present[1000] = {false};
+        ASSERT_TEST(keyed != NULL && list != NULL, destroy);
+        srand(21);
+        // mostly scheduler like, priorities a little after the first one, sometimes anywhere, ties included
+        int now = 1000000;
+        for (int step = 0; step < 5000; step++) {
+            int elem = rand() % 1000;
+            int prio = step % 10 == 0 ? rand() % 2000000 - 1000000 : now - rand() % 100;
+            PQ pqs[] = {keyed, list};
+            for (int i = 0; i < 2; i++) {
+                if (!present[elem]) {
+                    ASSERT_TEST(pqInsert(pqs[i], &elem, &prio) == PQ_SUCCESS, destroy);
+                } else if (step % 2 == 0) {
+                    ASSERT_TEST(pqRemoveElement(pqs[i], &elem) == PQ_SUCCESS, destroy);
+                } else {
+                    ASSERT_TEST(pqChangePriority(pqs[i], &elem, &priorities[elem], &prio) == PQ_SUCCESS, destroy);
+                }
+            }
+            present[elem] = !present[elem] || step % 2 != 0;
+            priorities[elem] = prio;
+            if (step % 3 == 0) {
+                PQElement first = NULL;
+                PQElementPriority first_priority = NULL;
+                ASSERT_TEST(pqPopFirst(keyed, &first, &first_priority) == PQ_SUCCESS, destroy);
+                ASSERT_TEST(*(int *) first == *(int *) pqGetFirst(list), destroy);
+                now = *(int *) first_priority;
+                present[*(int *) first] = false;
+                freeIntGeneric(first);
+                freeIntGeneric(first_priority);
+                ASSERT_TEST(pqRemove(list) == PQ_SUCCESS, destroy);
+            }
+        }
+        copy = pqCopy(keyed);
+        ASSERT_TEST(copy != NULL, destroy);
+        ASSERT_TEST(pqGetSize(keyed) == pqGetSize(list) && pqGetSize(copy) == pqGetSize(list), destroy);
+        int *expected = pqGetFirst(list);
+        PQ_FOREACH(int *, current, keyed) {
+            ASSERT_TEST(expected != NULL && *current == *expected, destroy);
+            expected = pqGetNext(list);
+        }
+        ASSERT_TEST(expected == NULL, destroy);
+        expected = pqGetFirst(list);
+        while (pqGetSize(copy) > 0) {
+            ASSERT_TEST(*(int *) pqGetFirst(copy) == *expected, destroy);
+            ASSERT_TEST(pqRemove(copy) == PQ_SUCCESS, destroy);
+            expected = pqGetNext(list);
+        }
+        ASSERT_TEST(expected == NULL, destroy);
+        pqDestroy(keyed);
+        pqDestroy(list);
+        pqDestroy(copy);
+        keyed = list = copy = NULL;
+    }
+
+    destroy:
+    pqDestroy(keyed);
+    pqDestroy(list);
+    pqDestroy(copy);
+    return result;
+}
+
+bool testPQCalendarQueueResizesWithTheKeys() {
+    bool result = true;
+    PQ pq = createKeyedPQ(PQ_BACKEND_CALENDAR_QUEUE);
+    ASSERT_TEST(pq != NULL, destroy);
+    srand(22);
+    // most priorities in the next 90 days, a few far out, many days shared. Higher ints come first, so
+    // days count down
+    int today = 100000;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 3000; i++) {
+            int elem = round * 3000 + i;
+            int prio = rand() % 20 == 0 ? today - rand() % 36000 : today - rand() % 90;
+            ASSERT_TEST(pqInsert(pq, &elem, &prio) == PQ_SUCCESS, destroy);
+        }
+        // some days pass, and so do their events
+        int last_prio = today, last_elem = -1;
+        today -= 30;
+        while (pqGetSize(pq) > 0) {
+            PQElement elem = NULL;
+            PQElementPriority prio = NULL;
+            ASSERT_TEST(pqPeekTopK(pq, 1, &elem, &prio) == 1, destroy);
+            if (*(int *) prio < today && round < 2) {
+                break;
+            }
+            ASSERT_TEST(*(int *) prio < last_prio || (*(int *) prio == last_prio && *(int *) elem > last_elem),
+                        destroy);
+            last_prio = *(int *) prio;
+            last_elem = *(int *) elem;
+            ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+        }
+    }
+    ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+    // an element before the first one
+    int elem = 1, early = 200000, late = 0;
+    ASSERT_TEST(pqInsert(pq, &elem, &late) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqInsert(pq, &elem, &early) == PQ_SUCCESS, destroy);
+    PQElementPriority first = NULL;
+    ASSERT_TEST(pqPopFirst(pq, NULL, &first) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(*(int *) first == early, destroy);
+    freeIntGeneric(first);
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQLazyRemovalRemoveLast() {
+    bool result = true;
+    PQ pq = NULL;
+    for (int b = 0; b < NUMBER_BACKENDS + NUMBER_KEYED_BACKENDS; b++) {
+        pq = b < NUMBER_BACKENDS ? createHashedPQ(allBackends[b]) : createKeyedPQ(keyedBackends[b - NUMBER_BACKENDS]);
+        ASSERT_TEST(pqSetLazyRemoval(pq, 1) == PQ_SUCCESS, destroy);
+        for (int i = 1; i <= 3; i++) {
+            ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+        }
+        // the removed last element is skipped, the one before it goes
+        int elem = 1;
+        ASSERT_TEST(pqRemoveElement(pq, &elem) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqRemoveLast(pq) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 1, destroy);
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == 3 && *(int *) pqGetLast(pq) == 3, destroy);
+        // only removed elements are left, removing the last one finds nothing to remove
+        elem = 3;
+        ASSERT_TEST(pqRemoveElement(pq, &elem) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqRemoveLast(pq) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        ASSERT_TEST(pqGetFirst(pq) == NULL && pqGetLast(pq) == NULL, destroy);
+        ASSERT_TEST(pqInsert(pq, &elem, &elem) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqRemoveElement(pq, &elem) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqRemoveLast(pq) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+        ASSERT_TEST(pqInsert(pq, &elem, &elem) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqGetSize(pq) == 1 && *(int *) pqGetFirst(pq) == 3, destroy);
+        pqDestroy(pq);
+        pq = NULL;
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+
 /* ============= Course given tests ============= */
 bool testPQCreateDestroy() {
     bool result = true;
@@ -834,7 +2590,47 @@ bool (*tests[])(void) = {
         testPQGetNextStandardTest,
         testPQGetNextTraversesTheQueueCorrectlyByPriority,
         testPQClearStandardTest,
-        testPQClearWorksOkayOnEmptyQueue
+        testPQClearWorksOkayOnEmptyQueue,
+        testPQCreateWithBackendUnknownBackend,
+        testPQBinaryHeapRemovesByPriorityAndInsertionOrder,
+        testPQBinaryHeapIteratesByPriority,
+        testPQHandleSampleNullArgument,
+        testPQChangePriorityByHandleReinsertsTheElement,
+        testPQRemoveByHandleRemovesOnlyThatElement,
+        testPQHashedFindsAndRemovesHighestPriorityEqualElement,
+        testPQHashedCopyAndClearKeepTheIndex,
+        testPQReserveSampleNullArgument,
+        testPQReserveThenChurnReusesNodes,
+        testPQInsertNoCopyTakesOwnership,
+        testPQPopFirstHandsOverTheElement,
+        testPQPopWhileDrainsMatchingHeadInOrder,
+        testPQInsertBatchOrdersAndKeepsTies,
+        testPQInsertBatchRejectsNullEntries,
+        testPQInsertMonotoneAndNearlySorted,
+        testPQCursorWalksWithoutTheInternalIterator,
+        testPQCursorRemoveCurrentKeepsTheCursor,
+        testTypedPQKeepsTheGenericOrder,
+        testPQInlineStoresValuesInPlace,
+        testPQInlineHandsOverMallocBlocks,
+        testPQMergeMovesAllAndKeepsTies,
+        testPQMergeRejectsDifferentQueues,
+        testPQPeekTopKLeavesTheQueueAlone,
+        testPQToSortedArrayKeepsTheIterator,
+        testPQRemoveLastFollowsTheOrderBackwards,
+        testPQBoundedDropsTheLowest,
+        testConcurrentPQPopsInOrder,
+        testConcurrentPQManyThreads,
+        testMultiPQPopsEveryElementOnce,
+        testMultiPQManyThreads,
+        testBlockingPQPopsOnlyReadyElements,
+        testBlockingPQWakesWaitingConsumer,
+        testPQLazyRemovalSkipsRemovedElements,
+        testPQLazyRemovalCompacts,
+        testPQSkiplistKeepsTheOrderUnderChurn,
+        testPQKeyedBackendsNeedKeys,
+        testPQKeyedBackendsKeepTheOrderUnderChurn,
+        testPQCalendarQueueResizesWithTheKeys,
+        testPQLazyRemovalRemoveLast
 };
 
 const char *testNames[] = {
@@ -876,7 +2672,47 @@ const char *testNames[] = {
         "testPQGetNextStandardTest",
         "testPQGetNextTraversesTheQueueCorrectlyByPriority",
         "testPQClearStandardTest",
-        "testPQClearWorksOkayOnEmptyQueue"
+        "testPQClearWorksOkayOnEmptyQueue",
+        "testPQCreateWithBackendUnknownBackend",
+        "testPQBinaryHeapRemovesByPriorityAndInsertionOrder",
+        "testPQBinaryHeapIteratesByPriority",
+        "testPQHandleSampleNullArgument",
+        "testPQChangePriorityByHandleReinsertsTheElement",
+        "testPQRemoveByHandleRemovesOnlyThatElement",
+        "testPQHashedFindsAndRemovesHighestPriorityEqualElement",
+        "testPQHashedCopyAndClearKeepTheIndex",
+        "testPQReserveSampleNullArgument",
+        "testPQReserveThenChurnReusesNodes",
+        "testPQInsertNoCopyTakesOwnership",
+        "testPQPopFirstHandsOverTheElement",
+        "testPQPopWhileDrainsMatchingHeadInOrder",
+        "testPQInsertBatchOrdersAndKeepsTies",
+        "testPQInsertBatchRejectsNullEntries",
+        "testPQInsertMonotoneAndNearlySorted",
+        "testPQCursorWalksWithoutTheInternalIterator",
+        "testPQCursorRemoveCurrentKeepsTheCursor",
+        "testTypedPQKeepsTheGenericOrder",
+        "testPQInlineStoresValuesInPlace",
+        "testPQInlineHandsOverMallocBlocks",
+        "testPQMergeMovesAllAndKeepsTies",
+        "testPQMergeRejectsDifferentQueues",
+        "testPQPeekTopKLeavesTheQueueAlone",
+        "testPQToSortedArrayKeepsTheIterator",
+        "testPQRemoveLastFollowsTheOrderBackwards",
+        "testPQBoundedDropsTheLowest",
+        "testConcurrentPQPopsInOrder",
+        "testConcurrentPQManyThreads",
+        "testMultiPQPopsEveryElementOnce",
+        "testMultiPQManyThreads",
+        "testBlockingPQPopsOnlyReadyElements",
+        "testBlockingPQWakesWaitingConsumer",
+        "testPQLazyRemovalSkipsRemovedElements",
+        "testPQLazyRemovalCompacts",
+        "testPQSkiplistKeepsTheOrderUnderChurn",
+        "testPQKeyedBackendsNeedKeys",
+        "testPQKeyedBackendsKeepTheOrderUnderChurn",
+        "testPQCalendarQueueResizesWithTheKeys",
+        "testPQLazyRemovalRemoveLast"
 };
 
 const char *testFailDescriptions[] = {
@@ -918,11 +2754,51 @@ const char *testFailDescriptions[] = {
         "Please refer to the testing code at function: testPQGetNextStandardTest",
         "Please refer to the testing code at function: testPQGetNextTraversesTheQueueCorrectlyByPriority",
         "Please refer to the testing code at function: testPQClearStandardTest",
-        "Please refer to the testing code at function: testPQClearWorksOkayOnEmptyQueue"
+        "Please refer to the testing code at function: testPQClearWorksOkayOnEmptyQueue",
+        "Please refer to the testing code at function: testPQCreateWithBackendUnknownBackend",
+        "Please refer to the testing code at function: testPQBinaryHeapRemovesByPriorityAndInsertionOrder",
+        "Please refer to the testing code at function: testPQBinaryHeapIteratesByPriority",
+        "Please refer to the testing code at function: testPQHandleSampleNullArgument",
+        "Please refer to the testing code at function: testPQChangePriorityByHandleReinsertsTheElement",
+        "Please refer to the testing code at function: testPQRemoveByHandleRemovesOnlyThatElement",
+        "Please refer to the testing code at function: testPQHashedFindsAndRemovesHighestPriorityEqualElement",
+        "Please refer to the testing code at function: testPQHashedCopyAndClearKeepTheIndex",
+        "Please refer to the testing code at function: testPQReserveSampleNullArgument",
+        "Please refer to the testing code at function: testPQReserveThenChurnReusesNodes",
+        "Please refer to the testing code at function: testPQInsertNoCopyTakesOwnership",
+        "Please refer to the testing code at function: testPQPopFirstHandsOverTheElement",
+        "Please refer to the testing code at function: testPQPopWhileDrainsMatchingHeadInOrder",
+        "Please refer to the testing code at function: testPQInsertBatchOrdersAndKeepsTies",
+        "Please refer to the testing code at function: testPQInsertBatchRejectsNullEntries",
+        "Please refer to the testing code at function: testPQInsertMonotoneAndNearlySorted",
+        "Please refer to the testing code at function: testPQCursorWalksWithoutTheInternalIterator",
+        "Please refer to the testing code at function: testPQCursorRemoveCurrentKeepsTheCursor",
+        "Please refer to the testing code at function: testTypedPQKeepsTheGenericOrder",
+        "Please refer to the testing code at function: testPQInlineStoresValuesInPlace",
+        "Please refer to the testing code at function: testPQInlineHandsOverMallocBlocks",
+        "Please refer to the testing code at function: testPQMergeMovesAllAndKeepsTies",
+        "Please refer to the testing code at function: testPQMergeRejectsDifferentQueues",
+        "Please refer to the testing code at function: testPQPeekTopKLeavesTheQueueAlone",
+        "Please refer to the testing code at function: testPQToSortedArrayKeepsTheIterator",
+        "Please refer to the testing code at function: testPQRemoveLastFollowsTheOrderBackwards",
+        "Please refer to the testing code at function: testPQBoundedDropsTheLowest",
+        "Please refer to the testing code at function: testConcurrentPQPopsInOrder",
+        "Please refer to the testing code at function: testConcurrentPQManyThreads",
+        "Please refer to the testing code at function: testMultiPQPopsEveryElementOnce",
+        "Please refer to the testing code at function: testMultiPQManyThreads",
+        "Please refer to the testing code at function: testBlockingPQPopsOnlyReadyElements",
+        "Please refer to the testing code at function: testBlockingPQWakesWaitingConsumer",
+        "Please refer to the testing code at function: testPQLazyRemovalSkipsRemovedElements",
+        "Please refer to the testing code at function: testPQLazyRemovalCompacts",
+        "Please refer to the testing code at function: testPQSkiplistKeepsTheOrderUnderChurn",
+        "Please refer to the testing code at function: testPQKeyedBackendsNeedKeys",
+        "Please refer to the testing code at function: testPQKeyedBackendsKeepTheOrderUnderChurn",
+        "Please refer to the testing code at function: testPQCalendarQueueResizesWithTheKeys",
+        "Please refer to the testing code at function: testPQLazyRemovalRemoveLast"
 };
 
 
-#define NUMBER_TESTS 39
+#define NUMBER_TESTS 79
 
 int main(int argc, char **argv) {
     if (argc == 1) {